@@ -10,7 +10,7 @@ physics::AABB BoxCollider2D::bounding_box() const
 	const Vector3f p1 = Vector3f(-0.5f, -0.5f, -1);
 	const Vector3f p2 = Vector3f(0.5f, 0.5f, 1);
 
-	const Matrix4x4f transform = owner().transform_matrix();
+	const Matrix4x4f& transform = owner().transform_matrix();
 	const Vector3f p1_m = transform * p1;
 	const Vector3f p2_m = transform * p2;
 
@@ -36,8 +36,7 @@ void FlyCamController::tick(float delta_time)
 		return;
 	}
 
-	const peng::shared_ref<Camera> camera = Camera::current().lock().to_shared_ref();
-	Transform& camera_transform = camera->local_transform();
+	Transform& camera_transform = Camera::current()->local_transform();
 
 	const Vector3f fly_forwards = camera_transform.local_forwards();
 	const Vector3f fly_right = camera_transform.local_right();
@@ -11,6 +11,7 @@
 #include <rendering/primitives.h>
 #include <rendering/material.h>
 #include <rendering/render_queue.h>
+#include <profiling/scoped_event.h>
 #include <utils/utils.h>
 #include <math/math.h>
 
@@ -21,6 +22,10 @@ using namespace components;
 using namespace rendering;
 using namespace math;
 
+bool MeshRenderer::_gathering_lights = false;
+std::vector<const PointLight*> MeshRenderer::_frame_point_lights;
+std::vector<const SpotLight*> MeshRenderer::_frame_spot_lights;
+
 MeshRenderer::MeshRenderer()
 	: MeshRenderer(
 		Primitives::cube(),
@@ -67,7 +72,7 @@ void MeshRenderer::tick(float delta_time)
 
 	if (_cached_uniforms.model_matrix >= 0)
 	{
-		const Matrix4x4f model_matrix = owner().transform_matrix();
+		const Matrix4x4f& model_matrix = owner().transform_matrix();
 		_material->set_parameter(_cached_uniforms.model_matrix, model_matrix);
 
 		if (_cached_uniforms.normal_matrix >= 0)
@@ -92,7 +97,7 @@ void MeshRenderer::tick(float delta_time)
 
 		// Point lights
 		{
-			const std::vector<peng::shared_ref<const PointLight>> point_lights = get_relevant_point_lights();
+			const memory::frame_vector<peng::borrowed_ptr<const PointLight>> point_lights = get_relevant_point_lights();
 			for (int32_t i = 0; i < _max_point_lights; i++)
 			{
 				const Vector3f light_pos = i < point_lights.size()
@@ -114,7 +119,7 @@ void MeshRenderer::tick(float delta_time)
 
 		// Spot lights
 		{
-			const std::vector<peng::shared_ref<const SpotLight>> spot_lights = get_relevant_spot_lights();
+			const memory::frame_vector<peng::borrowed_ptr<const SpotLight>> spot_lights = get_relevant_spot_lights();
 			for (int32_t i = 0; i < _max_spot_lights; i++)
 			{
 				const Vector3f light_pos = i < spot_lights.size()
@@ -149,7 +154,7 @@ void MeshRenderer::tick(float delta_time)
 			// TODO: support multiple directional lights
 			for (int32_t i = 0; i < _max_directional_lights; i++)
 			{
-				peng::weak_ptr<DirectionalLight> directional_light = i == 0
+				const peng::weak_ptr<const DirectionalLight> directional_light = i == 0
 					? DirectionalLight::current()
 					: peng::weak_ptr<DirectionalLight>{};
 
@@ -188,6 +193,12 @@ void MeshRenderer::post_create()
 {
 	Component::post_create();
 
+	if (!_gathering_lights)
+	{
+		EntitySubsystem::get().pre_tick_entity_group().subscribe(&MeshRenderer::gather_lights);
+		_gathering_lights = true;
+	}
+
 	if (_material)
 	{
 		cache_uniforms();
@@ -210,6 +221,31 @@ void MeshRenderer::set_material(const peng::shared_ptr<Material>& material)
 	}
 }
 
+void MeshRenderer::gather_lights(TickGroup tick_group)
+{
+	if (tick_group != TickGroup::render_parallel)
+	{
+		return;
+	}
+
+	SCOPED_EVENT("MeshRenderer - gather lights");
+
+	_frame_point_lights.clear();
+	for (const PointLight& light : EntitySubsystem::get().find_entities_of_type<PointLight>())
+	{
+		if (light.active_in_hierarchy())
+		{
+			_frame_point_lights.push_back(&light);
+		}
+	}
+
+	_frame_spot_lights.clear();
+	for (const SpotLight& light : EntitySubsystem::get().find_entities_of_type<SpotLight>())
+	{
+		_frame_spot_lights.push_back(&light);
+	}
+}
+
 void MeshRenderer::cache_uniforms()
 {
 	check(_material);
@@ -316,35 +352,31 @@ void MeshRenderer::cache_uniforms()
 	}
 }
 
-std::vector<peng::shared_ref<const PointLight>> MeshRenderer::get_relevant_point_lights()
+memory::frame_vector<peng::borrowed_ptr<const PointLight>> MeshRenderer::get_relevant_point_lights()
 {
 	struct Consideration
 	{
-		peng::shared_ref<const PointLight> light;
+		peng::borrowed_ptr<const PointLight> light;
 		float relevance;
 	};
 
-	// Start with all active point lights
-	const std::vector<peng::weak_ptr<PointLight>> active_lights = PointLight::active_lights();
-
 	// Calculate the relative strength for each light to the origin of this object
-	// Drop any invalid or disabled lights
+	// Disabled lights were already dropped when the lights were gathered
 	// TODO: consider relative strength to bounding box instead
 	// TODO: skip considerations if we don't need to do them
-	std::vector<Consideration> considerations;
-	for (const peng::weak_ptr<PointLight>& light : active_lights)
+	memory::frame_vector<Consideration> considerations;
+	considerations.reserve(_frame_point_lights.size());
+
+	for (const PointLight* light : _frame_point_lights)
 	{
-		if (light && light->active_in_hierarchy())
-		{
-			const float light_intensity_sqr = light->data().color.magnitude_sqr() * light->data().range * light->data().range;
-			const float light_dist_sqr = (light->world_position() - owner().world_position()).magnitude_sqr();
-			const float relative_strength = light_intensity_sqr / light_dist_sqr;
-
-			considerations.emplace_back(Consideration{
-				.light = light.lock().to_shared_ref(),
-				.relevance = relative_strength
-			});
-		}
+		const float light_intensity_sqr = light->data().color.magnitude_sqr() * light->data().range * light->data().range;
+		const float light_dist_sqr = (light->world_position() - owner().world_position()).magnitude_sqr();
+		const float relative_strength = light_intensity_sqr / light_dist_sqr;
+
+		considerations.emplace_back(Consideration{
+			.light = peng::borrowed_ptr<const PointLight>(light),
+			.relevance = relative_strength
+		});
 	}
 
 	// Sort by relevance
@@ -354,7 +386,9 @@ std::vector<peng::shared_ref<const PointLight>> MeshRenderer::get_relevant_point
 	});
 
 	// Only pick the most relevant ones
-	std::vector<peng::shared_ref<const PointLight>> relevant_lights;
+	memory::frame_vector<peng::borrowed_ptr<const PointLight>> relevant_lights;
+	relevant_lights.reserve(std::min<size_t>(considerations.size(), _max_point_lights));
+
 	for (size_t i = 0; i < std::min<size_t>(considerations.size(), _max_point_lights); i++)
 	{
 		relevant_lights.push_back(considerations[i].light);
@@ -364,19 +398,19 @@ std::vector<peng::shared_ref<const PointLight>> MeshRenderer::get_relevant_point
 }
 
 // TODO: this just returns the first n lights - make a proper implementation
-std::vector<peng::shared_ref<const SpotLight>> MeshRenderer::get_relevant_spot_lights()
+memory::frame_vector<peng::borrowed_ptr<const SpotLight>> MeshRenderer::get_relevant_spot_lights()
 {
-	std::vector<peng::shared_ref<const SpotLight>> relevant_lights;
-	for (peng::weak_ptr<SpotLight> spot_light : SpotLight::active_lights())
+	memory::frame_vector<peng::borrowed_ptr<const SpotLight>> relevant_lights;
+	relevant_lights.reserve(std::min<size_t>(_frame_spot_lights.size(), _max_spot_lights));
+
+	for (const SpotLight* spot_light : _frame_spot_lights)
 	{
-	    if (spot_light)
-	    {
-			relevant_lights.push_back(spot_light.lock().to_shared_ref());
-			if (relevant_lights.size() >= _max_spot_lights)
-			{
-			    break;
-			}
-	    }
+		if (relevant_lights.size() >= _max_spot_lights)
+		{
+			break;
+		}
+
+		relevant_lights.emplace_back(spot_light);
 	}
 
 	return relevant_lights;
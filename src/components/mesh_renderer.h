@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory/borrowed_ptr.h>
+#include <memory/frame_allocator.h>
 #include <core/component.h>
 
 namespace entities
@@ -45,9 +47,13 @@ namespace components
 		[[nodiscard]] const peng::shared_ptr<rendering::Material>& material() const noexcept { return _material; }
 
 	private:
+		// Gathers the lights shared by every renderer once per frame, before the renderers tick concurrently
+		// Lights are kept in entity index order, which is creation order until a light is destroyed
+		static void gather_lights(TickGroup tick_group);
+
 		void cache_uniforms();
-		std::vector<peng::shared_ref<const entities::PointLight>> get_relevant_point_lights();
-		std::vector<peng::shared_ref<const entities::SpotLight>> get_relevant_spot_lights();
+		memory::frame_vector<peng::borrowed_ptr<const entities::PointLight>> get_relevant_point_lights();
+		memory::frame_vector<peng::borrowed_ptr<const entities::SpotLight>> get_relevant_spot_lights();
 
 		peng::shared_ptr<const rendering::Mesh> _mesh;
 		peng::shared_ptr<rendering::Material> _material;
@@ -92,6 +98,10 @@ namespace components
 			std::vector<DirectionalLightUniformSet> directional_lights;
 		};
 
+		static bool _gathering_lights;
+		static std::vector<const entities::PointLight*> _frame_point_lights;
+		static std::vector<const entities::SpotLight*> _frame_spot_lights;
+
 		bool _uses_lighting = false;
 		int32_t _max_point_lights = 0;
 		int32_t _max_spot_lights = 0;
@@ -13,6 +13,13 @@ RigidBody::RigidBody()
 	SERIALIZED_MEMBER(velocity);
 }
 
+void RigidBody::post_create()
+{
+	Component::post_create();
+
+	owner().set_physics_interpolated(true);
+}
+
 void RigidBody::tick(float delta_time)
 {
 	Component::tick(delta_time);
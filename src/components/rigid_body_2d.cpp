@@ -13,6 +13,13 @@ RigidBody2D::RigidBody2D()
 	SERIALIZED_MEMBER(velocity);
 }
 
+void RigidBody2D::post_create()
+{
+	Component::post_create();
+
+	owner().set_physics_interpolated(true);
+}
+
 void RigidBody2D::tick(float delta_time)
 {
 	Component::tick(delta_time);
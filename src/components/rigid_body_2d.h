@@ -4,14 +4,21 @@
 
 namespace components
 {
-	// TODO: needs to use some kind of fixed_tick instead of tick
+	// Ticks at the fixed physics rate, with the owner interpolated between steps when rendering
 	class RigidBody2D final : public Component
 	{
 		DECLARE_COMPONENT(RigidBody2D);
 
 	public:
+		// Instances don't tick concurrently with each other since moving the owner invalidates its children
+		static constexpr TickAccess tick_access = {
+			.reads = DataDomain::physics,
+			.writes = DataDomain::transforms
+		};
+
 		RigidBody2D();
 
+		void post_create() override;
 		void tick(float delta_time) override;
 
 		math::Vector2f velocity;
@@ -37,7 +37,7 @@ void SpriteRenderer::tick(float delta_time)
 		return;
 	}
 
-	const Matrix4x4f model_matrix = owner().transform_matrix();
+	const Matrix4x4f& model_matrix = owner().transform_matrix();
 	const Matrix4x4f view_matrix = Camera::current()->view_matrix();
 	const Matrix4x4f mvp_matrix = view_matrix * model_matrix;
 
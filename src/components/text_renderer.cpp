@@ -31,7 +31,7 @@ void TextRenderer::tick(float delta_time)
     }
 
     const Matrix4x4f view_matrix = Camera::current()->view_matrix();
-    const Matrix4x4f model_matrix = owner().transform_matrix();
+    const Matrix4x4f& model_matrix = owner().transform_matrix();
     const Matrix4x4f mvp_matrix = view_matrix * model_matrix;
 
     for (const GlyphData& glyph : _current_glyphs)
@@ -0,0 +1,81 @@
+#include "archetype.h"
+
+#include <utils/check.h>
+
+#include "entity.h"
+#include "reflected_type.h"
+#include "component.h"
+
+Archetype::Archetype(ComponentSignature&& signature)
+	: _signature(std::move(signature))
+	, _num_entities(0)
+{ }
+
+void Archetype::add_entity(Entity& entity, const std::vector<Component*>& sorted_components)
+{
+	check(entity._archetype == nullptr);
+	check(sorted_components.size() == _signature.size());
+
+	if (_chunks.empty() || _chunks.back()->size == chunk_capacity)
+	{
+		std::unique_ptr<Chunk>& chunk = _chunks.emplace_back(std::make_unique<Chunk>());
+		chunk->columns.resize(_signature.size());
+	}
+
+	Chunk& chunk = *_chunks.back();
+	const int32_t row = chunk.size++;
+
+	chunk.entities[row] = &entity;
+	for (size_t column_index = 0; column_index < chunk.columns.size(); column_index++)
+	{
+		Component* component = sorted_components[column_index];
+		Column& column = chunk.columns[column_index];
+
+		column.components[row] = component;
+		column.tick_groups[row] = _signature[column_index]->has_tick
+			? component->tick_group()
+			: TickGroup::none;
+	}
+
+	entity._archetype = this;
+	entity._archetype_index = _num_entities++;
+}
+
+void Archetype::remove_entity(Entity& entity)
+{
+	check(entity._archetype == this);
+
+	const int32_t index = entity._archetype_index;
+	const int32_t last_index = --_num_entities;
+
+	Chunk& chunk = *_chunks[index / chunk_capacity];
+	Chunk& last_chunk = *_chunks.back();
+
+	const int32_t row = index % chunk_capacity;
+	const int32_t last_row = --last_chunk.size;
+
+	// Swap the last row into the freed slot to keep the chunks dense
+	if (index != last_index)
+	{
+		Entity* moved_entity = last_chunk.entities[last_row];
+		moved_entity->_archetype_index = index;
+
+		chunk.entities[row] = moved_entity;
+		for (size_t column_index = 0; column_index < chunk.columns.size(); column_index++)
+		{
+			const Column& last_column = last_chunk.columns[column_index];
+			Column& column = chunk.columns[column_index];
+
+			column.components[row] = last_column.components[last_row];
+			column.tick_groups[row] = last_column.tick_groups[last_row];
+		}
+	}
+
+	if (last_chunk.size == 0)
+	{
+		_chunks.pop_back();
+	}
+
+	entity._archetype = nullptr;
+	entity._archetype_index = -1;
+}
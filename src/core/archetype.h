@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+
+#include "tickable.h"
+
+class Entity;
+class Component;
+struct ReflectedType;
+
+// Sorted list of the component types owned by an entity, used to group entities into archetypes
+// Entities with several components of the same type will have that type repeated in the signature
+using ComponentSignature = std::vector<const ReflectedType*>;
+
+// Groups all entities that share an identical component signature into fixed size chunks
+// Each column holds pointers to the components of one type alongside their tick groups, so finding the
+// components due to tick only reads the chunk, but each component ticked is still a pointer chase and a
+// virtual call. Components are polymorphic and referenced through shared and weak pointers, so they
+// can't be stored by value and relocated when an entity changes archetype
+class Archetype
+{
+public:
+	static constexpr int32_t chunk_capacity = 256;
+
+	struct Column
+	{
+		std::array<Component*, chunk_capacity> components;
+		std::array<TickGroup, chunk_capacity> tick_groups;
+	};
+
+	struct Chunk
+	{
+		int32_t size = 0;
+		std::array<Entity*, chunk_capacity> entities;
+		std::vector<Column> columns;
+	};
+
+	explicit Archetype(ComponentSignature&& signature);
+
+	Archetype(const Archetype&) = delete;
+	Archetype(Archetype&&) = delete;
+
+	// Adds an entity to the archetype, components must be sorted to match the signature
+	void add_entity(Entity& entity, const std::vector<Component*>& sorted_components);
+
+	// Removes an entity from the archetype by swapping the last row into its place
+	// The last chunk is released as soon as it becomes empty
+	void remove_entity(Entity& entity);
+
+	[[nodiscard]] const ComponentSignature& signature() const noexcept { return _signature; }
+	[[nodiscard]] const std::vector<std::unique_ptr<Chunk>>& chunks() const noexcept { return _chunks; }
+	[[nodiscard]] int32_t num_entities() const noexcept { return _num_entities; }
+
+private:
+	ComponentSignature _signature;
+	std::vector<std::unique_ptr<Chunk>> _chunks;
+	int32_t _num_entities;
+};
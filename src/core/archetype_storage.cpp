@@ -0,0 +1,104 @@
+#include "archetype_storage.h"
+
+#include <algorithm>
+
+#include "entity.h"
+#include "component.h"
+
+void ArchetypeStorage::add_entity(Entity& entity)
+{
+	_sorted_components.clear();
+	for (const peng::shared_ref<Component>& component : entity.components())
+	{
+		_sorted_components.push_back(component.get());
+	}
+
+	// Components are sorted by type so that entities with the same set of components
+	// always produce the same signature regardless of the order they were added in
+	std::ranges::stable_sort(_sorted_components, std::less(), [](const Component* component)
+	{
+		return component->type().get();
+	});
+
+	ComponentSignature signature;
+	signature.reserve(_sorted_components.size());
+
+	for (const Component* component : _sorted_components)
+	{
+		signature.push_back(component->type().get());
+	}
+
+	Archetype& archetype = find_or_create_archetype(std::move(signature));
+	archetype.add_entity(entity, _sorted_components);
+}
+
+void ArchetypeStorage::remove_entity(Entity& entity)
+{
+	Archetype* archetype = entity._archetype;
+	if (!archetype)
+	{
+		return;
+	}
+
+	archetype->remove_entity(entity);
+
+	if (archetype->num_entities() == 0)
+	{
+		// Looked up before erasing since the signature is owned by the archetype being destroyed
+		const auto it = _archetype_map.find(archetype->signature());
+		std::erase(_archetypes, archetype);
+		_archetype_map.erase(it);
+	}
+}
+
+void ArchetypeStorage::refresh_entity(Entity& entity)
+{
+	remove_entity(entity);
+	add_entity(entity);
+}
+
+void ArchetypeStorage::clear()
+{
+	for (Archetype* archetype : _archetypes)
+	{
+		for (const std::unique_ptr<Archetype::Chunk>& chunk : archetype->chunks())
+		{
+			for (int32_t row = 0; row < chunk->size; row++)
+			{
+				chunk->entities[row]->_archetype = nullptr;
+				chunk->entities[row]->_archetype_index = -1;
+			}
+		}
+	}
+
+	_archetypes.clear();
+	_archetype_map.clear();
+}
+
+void ArchetypeStorage::gather_chunks(std::vector<Archetype::Chunk*>& chunks) const
+{
+	for (const Archetype* archetype : _archetypes)
+	{
+		for (const std::unique_ptr<Archetype::Chunk>& chunk : archetype->chunks())
+		{
+			chunks.push_back(chunk.get());
+		}
+	}
+}
+
+Archetype& ArchetypeStorage::find_or_create_archetype(ComponentSignature&& signature)
+{
+	const auto it = _archetype_map.find(signature);
+	if (it != _archetype_map.end())
+	{
+		return *it->second;
+	}
+
+	std::unique_ptr<Archetype> archetype = std::make_unique<Archetype>(std::move(signature));
+	Archetype& archetype_ref = *archetype;
+
+	_archetypes.push_back(archetype.get());
+	_archetype_map.emplace(archetype_ref.signature(), std::move(archetype));
+
+	return archetype_ref;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include <memory>
+
+#include "archetype.h"
+
+// Owns all archetypes and tracks which archetype each entity lives in
+class ArchetypeStorage
+{
+public:
+	ArchetypeStorage() = default;
+	ArchetypeStorage(const ArchetypeStorage&) = delete;
+	ArchetypeStorage(ArchetypeStorage&&) = delete;
+
+	// Places an entity into the archetype matching its current components
+	void add_entity(Entity& entity);
+
+	// Removes an entity from whichever archetype it currently lives in
+	// Archetypes left without any entities are destroyed
+	void remove_entity(Entity& entity);
+
+	// Moves an entity to a new archetype after its set of components has changed
+	void refresh_entity(Entity& entity);
+
+	void clear();
+
+	// Gathers every chunk across all archetypes into the provided buffer
+	void gather_chunks(std::vector<Archetype::Chunk*>& chunks) const;
+
+	[[nodiscard]] const std::vector<Archetype*>& archetypes() const noexcept { return _archetypes; }
+
+private:
+	Archetype& find_or_create_archetype(ComponentSignature&& signature);
+
+	std::map<ComponentSignature, std::unique_ptr<Archetype>> _archetype_map;
+	std::vector<Archetype*> _archetypes;
+
+	std::vector<Component*> _sorted_components;
+};
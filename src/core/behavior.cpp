@@ -0,0 +1,18 @@
+#include "behavior.h"
+
+#include "entity_subsystem.h"
+
+void detail::wait_next_frame(BehaviorId id)
+{
+	EntitySubsystem::get().behavior_scheduler().wait_next_frame(id);
+}
+
+void detail::wait_seconds(BehaviorId id, float seconds)
+{
+	EntitySubsystem::get().behavior_scheduler().wait_seconds(id, seconds);
+}
+
+void detail::wake_behavior(BehaviorId id)
+{
+	EntitySubsystem::get().behavior_scheduler().wake(id);
+}
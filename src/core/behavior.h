@@ -0,0 +1,175 @@
+#pragma once
+
+#include <tuple>
+#include <utility>
+#include <optional>
+#include <cstdint>
+#include <exception>
+#include <coroutine>
+#include <type_traits>
+
+#include <utils/event.h>
+
+// Identifies a behavior within the behavior scheduler, ids of finished behaviors are never reused
+struct BehaviorId
+{
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	[[nodiscard]] bool operator==(const BehaviorId& other) const = default;
+};
+
+namespace detail
+{
+	void wait_next_frame(BehaviorId id);
+	void wait_seconds(BehaviorId id, float seconds);
+	void wake_behavior(BehaviorId id);
+}
+
+struct NextFrame { };
+
+struct WaitSeconds
+{
+	float seconds;
+};
+
+[[nodiscard]] constexpr NextFrame next_frame() noexcept { return { }; }
+[[nodiscard]] constexpr WaitSeconds seconds(float seconds) noexcept { return { seconds }; }
+
+class NextFrameAwaiter
+{
+public:
+	explicit NextFrameAwaiter(BehaviorId id) noexcept
+		: _id(id)
+	{ }
+
+	[[nodiscard]] bool await_ready() const noexcept { return false; }
+	void await_suspend(std::coroutine_handle<>) const { detail::wait_next_frame(_id); }
+	void await_resume() const noexcept { }
+
+private:
+	BehaviorId _id;
+};
+
+class SecondsAwaiter
+{
+public:
+	SecondsAwaiter(BehaviorId id, float seconds) noexcept
+		: _id(id)
+		, _seconds(seconds)
+	{ }
+
+	[[nodiscard]] bool await_ready() const noexcept { return _seconds <= 0; }
+	void await_suspend(std::coroutine_handle<>) const { detail::wait_seconds(_id, _seconds); }
+	void await_resume() const noexcept { }
+
+private:
+	BehaviorId _id;
+	float _seconds;
+};
+
+// Resumes the behavior after the event is next invoked, yielding a tuple of the event arguments
+// The event must outlive the wait, stopping the behavior while it waits removes the listener
+template <typename...Args>
+class EventAwaiter
+{
+public:
+	using result_type = std::tuple<std::decay_t<Args>...>;
+
+	EventAwaiter(utils::EventInterface<Args...>& event, BehaviorId id) noexcept
+		: _event(event)
+		, _id(id)
+	{ }
+
+	EventAwaiter(const EventAwaiter&) = delete;
+	EventAwaiter(EventAwaiter&&) = delete;
+
+	~EventAwaiter()
+	{
+		if (_listener != utils::EventInterface<Args...>::null_handle)
+		{
+			_event.unsubscribe(_listener);
+		}
+	}
+
+	[[nodiscard]] bool await_ready() const noexcept { return false; }
+
+	void await_suspend(std::coroutine_handle<>)
+	{
+		_listener = _event.subscribe_once([this](Args...args)
+		{
+			// The listener removes itself once invoked
+			_listener = utils::EventInterface<Args...>::null_handle;
+			_result.emplace(args...);
+			detail::wake_behavior(_id);
+		});
+	}
+
+	[[nodiscard]] result_type await_resume()
+	{
+		return std::move(*_result);
+	}
+
+private:
+	utils::EventInterface<Args...>& _event;
+	BehaviorId _id;
+	typename utils::EventInterface<Args...>::listener_handle _listener = utils::EventInterface<Args...>::null_handle;
+	std::optional<result_type> _result;
+};
+
+// Coroutine run by the behavior scheduler on behalf of an entity
+// Waiting behaviors are held by the scheduler and cost nothing until they are resumed
+//
+//   co_await next_frame();   resumes on the next frame
+//   co_await seconds(t);     resumes once t seconds have passed
+//   co_await event;          resumes after the event is next invoked, yielding a tuple of its arguments
+class Behavior
+{
+public:
+	struct promise_type;
+	using handle_type = std::coroutine_handle<promise_type>;
+
+	struct promise_type
+	{
+		// Assigned by the scheduler when the behavior is started
+		BehaviorId id;
+
+		Behavior get_return_object() noexcept { return Behavior(handle_type::from_promise(*this)); }
+		std::suspend_always initial_suspend() const noexcept { return { }; }
+		std::suspend_always final_suspend() const noexcept { return { }; }
+		void return_void() const noexcept { }
+		void unhandled_exception() const noexcept { std::terminate(); }
+
+		[[nodiscard]] NextFrameAwaiter await_transform(NextFrame) const noexcept { return NextFrameAwaiter(id); }
+		[[nodiscard]] SecondsAwaiter await_transform(WaitSeconds wait) const noexcept { return SecondsAwaiter(id, wait.seconds); }
+
+		template <typename...Args>
+		[[nodiscard]] EventAwaiter<Args...> await_transform(utils::EventInterface<Args...>& event) const noexcept
+		{
+			return EventAwaiter<Args...>(event, id);
+		}
+	};
+
+	Behavior(const Behavior&) = delete;
+	Behavior(Behavior&& other) noexcept
+		: _handle(std::exchange(other._handle, nullptr))
+	{ }
+
+	~Behavior()
+	{
+		if (_handle)
+		{
+			_handle.destroy();
+		}
+	}
+
+	// Hands ownership of the coroutine over to the caller
+	[[nodiscard]] handle_type release() noexcept { return std::exchange(_handle, nullptr); }
+
+private:
+	explicit Behavior(handle_type handle) noexcept
+		: _handle(handle)
+	{ }
+
+	handle_type _handle;
+};
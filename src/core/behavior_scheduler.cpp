@@ -0,0 +1,252 @@
+#include "behavior_scheduler.h"
+
+#include <cmath>
+
+#include <utils/check.h>
+#include <profiling/scoped_event.h>
+#include <profiling/counter.h>
+
+#include "entity.h"
+
+BehaviorScheduler::BehaviorScheduler()
+	: _num_behaviors(0)
+	, _time(0)
+{ }
+
+BehaviorId BehaviorScheduler::start(Behavior&& behavior, EntityHandle<Entity> owner)
+{
+	const Behavior::handle_type handle = behavior.release();
+	check(handle);
+
+	uint32_t index;
+	if (!_free_indices.empty())
+	{
+		index = _free_indices.back();
+		_free_indices.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(_tasks.size());
+		_tasks.emplace_back();
+	}
+
+	Task& task = _tasks[index];
+	task.handle = handle;
+	task.owner = owner;
+	task.state = TaskState::ready;
+	task.stop_requested = false;
+	_num_behaviors++;
+
+	const BehaviorId id = {
+		.index = index,
+		.generation = task.generation
+	};
+
+	handle.promise().id = id;
+	resume(id);
+
+	return id;
+}
+
+void BehaviorScheduler::stop(BehaviorId id)
+{
+	Task* task = find_task(id);
+	if (!task)
+	{
+		return;
+	}
+
+	// A running behavior can't be destroyed until it next suspends
+	if (task->state == TaskState::running)
+	{
+		task->stop_requested = true;
+		return;
+	}
+
+	release(id.index);
+}
+
+void BehaviorScheduler::wait_next_frame(BehaviorId id)
+{
+	Task* task = find_task(id);
+	check(task && task->state == TaskState::running);
+
+	task->state = TaskState::waiting;
+	_next_frame.push_back(id);
+}
+
+void BehaviorScheduler::wait_seconds(BehaviorId id, float seconds)
+{
+	Task* task = find_task(id);
+	check(task && task->state == TaskState::running);
+
+	// Measured from the current time rather than the current tick of the wheel so that sub-tick remainders aren't lost
+	const double wake_time = _time + seconds;
+	const uint64_t wake_tick = static_cast<uint64_t>(std::ceil(wake_time / timer_resolution));
+	const uint64_t delay = wake_tick > _timers.current_tick() ? wake_tick - _timers.current_tick() : 1;
+
+	task->state = TaskState::waiting;
+	task->timer = _timers.schedule(delay, [this, id]
+	{
+		wake(id);
+	});
+}
+
+void BehaviorScheduler::wake(BehaviorId id)
+{
+	Task* task = find_task(id);
+	if (!task || task->state != TaskState::waiting)
+	{
+		return;
+	}
+
+	task->state = TaskState::ready;
+	_ready.push_back(id);
+}
+
+void BehaviorScheduler::unpark(BehaviorId id)
+{
+	Task* task = find_task(id);
+	if (!task || task->state != TaskState::parked)
+	{
+		return;
+	}
+
+	task->state = TaskState::ready;
+	_ready.push_back(id);
+}
+
+bool BehaviorScheduler::running(BehaviorId id) const noexcept
+{
+	return find_task(id) != nullptr;
+}
+
+bool BehaviorScheduler::waiting(BehaviorId id) const noexcept
+{
+	const Task* task = find_task(id);
+	return task && (task->state == TaskState::waiting || task->state == TaskState::parked);
+}
+
+void BehaviorScheduler::tick(float delta_time)
+{
+	SCOPED_EVENT("BehaviorScheduler - tick");
+
+	_time += delta_time;
+
+	// Behaviors that wait for the next frame during this tick are left until the next one
+	std::swap(_waking, _next_frame);
+	for (const BehaviorId id : _waking)
+	{
+		wake(id);
+	}
+
+	_waking.clear();
+	_timers.advance_to(static_cast<uint64_t>(_time / timer_resolution));
+
+	// Behaviors woken while resuming others are resumed within the same tick
+	size_t num_resumed = 0;
+	for (; num_resumed < _ready.size(); num_resumed++)
+	{
+		resume(_ready[num_resumed]);
+	}
+
+	_ready.clear();
+
+	SET_COUNTER("BehaviorScheduler - resumed", num_resumed);
+	SET_COUNTER("BehaviorScheduler - behaviors", _num_behaviors);
+}
+
+void BehaviorScheduler::clear()
+{
+	for (uint32_t index = 0; index < _tasks.size(); index++)
+	{
+		if (_tasks[index].state != TaskState::free)
+		{
+			check(_tasks[index].state != TaskState::running);
+			release(index);
+		}
+	}
+
+	_ready.clear();
+	_next_frame.clear();
+	_timers.clear();
+}
+
+BehaviorScheduler::Task* BehaviorScheduler::find_task(BehaviorId id) noexcept
+{
+	return const_cast<Task*>(std::as_const(*this).find_task(id));
+}
+
+const BehaviorScheduler::Task* BehaviorScheduler::find_task(BehaviorId id) const noexcept
+{
+	if (id.index >= _tasks.size())
+	{
+		return nullptr;
+	}
+
+	const Task& task = _tasks[id.index];
+	if (task.generation != id.generation || task.state == TaskState::free)
+	{
+		return nullptr;
+	}
+
+	return &task;
+}
+
+void BehaviorScheduler::resume(BehaviorId id)
+{
+	Task* task = find_task(id);
+	if (!task || task->state != TaskState::ready)
+	{
+		return;
+	}
+
+	const Entity* owner = task->owner.get();
+	if (!owner)
+	{
+		release(id.index);
+		return;
+	}
+
+	// Inactive owners hold their behaviors back until they are reactivated, see Entity::unpark_behaviors
+	if (!owner->active_in_hierarchy())
+	{
+		task->state = TaskState::parked;
+		return;
+	}
+
+	const std::coroutine_handle<> handle = task->handle;
+	task->state = TaskState::running;
+
+	handle.resume();
+
+	// Starting other behaviors while running may have reallocated the tasks
+	task = &_tasks[id.index];
+	if (handle.done() || task->stop_requested)
+	{
+		release(id.index);
+	}
+	else
+	{
+		// Behaviors only suspend through the scheduler's awaiters, which always leave them waiting
+		check(task->state == TaskState::waiting);
+	}
+}
+
+void BehaviorScheduler::release(uint32_t index)
+{
+	Task& task = _tasks[index];
+	check(task.state != TaskState::free);
+
+	_timers.cancel(task.timer);
+	task.handle.destroy();
+
+	task.handle = nullptr;
+	task.owner = nullptr;
+	task.timer = { };
+	task.state = TaskState::free;
+	task.generation++;
+
+	_free_indices.push_back(index);
+	_num_behaviors--;
+}
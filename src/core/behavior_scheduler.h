@@ -0,0 +1,89 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <coroutine>
+
+#include "behavior.h"
+#include "timer_wheel.h"
+#include "entity_handle.h"
+
+class Entity;
+
+// Runs the coroutine behaviors of entities
+// Behaviors waiting on a frame sit in a queue, those waiting on time sit in a timer wheel and those waiting
+// on an event sit in the event itself, and those held back by an inactive owner are only tracked by the owner
+// so only behaviors that are due to resume cost anything each frame
+class BehaviorScheduler
+{
+public:
+	// Duration of a timer wheel tick in seconds
+	static constexpr double timer_resolution = 0.001;
+
+	BehaviorScheduler();
+	BehaviorScheduler(const BehaviorScheduler&) = delete;
+	BehaviorScheduler(BehaviorScheduler&&) = delete;
+
+	// Runs the behavior until it first waits
+	// Behaviors are stopped once their owner is destroyed, and don't resume while their owner is inactive
+	BehaviorId start(Behavior&& behavior, EntityHandle<Entity> owner);
+	void stop(BehaviorId id);
+
+	void wait_next_frame(BehaviorId id);
+	void wait_seconds(BehaviorId id, float seconds);
+
+	// Resumes a waiting behavior the next time the scheduler runs, or later this run if it is already running
+	void wake(BehaviorId id);
+
+	// Queues a behavior that came due while its owner was inactive, called by the owner once it is reactivated
+	void unpark(BehaviorId id);
+
+	[[nodiscard]] bool running(BehaviorId id) const noexcept;
+	[[nodiscard]] bool waiting(BehaviorId id) const noexcept;
+
+	// Advances the timers and resumes every behavior that is due
+	void tick(float delta_time);
+	void clear();
+
+	[[nodiscard]] size_t num_behaviors() const noexcept { return _num_behaviors; }
+
+private:
+	enum class TaskState
+	{
+		free,
+		ready,
+		waiting,
+		running,
+
+		// Due while the owner was inactive, left out of every queue until the owner unparks it
+		parked
+	};
+
+	struct Task
+	{
+		std::coroutine_handle<> handle;
+		EntityHandle<Entity> owner;
+		TimerWheel::Handle timer;
+
+		uint32_t generation = 1;
+		TaskState state = TaskState::free;
+		bool stop_requested = false;
+	};
+
+	[[nodiscard]] Task* find_task(BehaviorId id) noexcept;
+	[[nodiscard]] const Task* find_task(BehaviorId id) const noexcept;
+
+	void resume(BehaviorId id);
+	void release(uint32_t index);
+
+	std::vector<Task> _tasks;
+	std::vector<uint32_t> _free_indices;
+	size_t _num_behaviors;
+
+	std::vector<BehaviorId> _ready;
+	std::vector<BehaviorId> _next_frame;
+	std::vector<BehaviorId> _waking;
+
+	TimerWheel _timers;
+	double _time;
+};
@@ -1,11 +1,13 @@
 #include "component.h"
 
 #include "logger.h"
+#include "entity.h"
 
 IMPLEMENT_COMPONENT(Component);
 
 Component::Component(TickGroup tick_group)
 	: _tick_group(tick_group)
+	, _created_by_owner(false)
 { }
 
 TickGroup Component::tick_group() const noexcept
@@ -13,6 +15,11 @@ TickGroup Component::tick_group() const noexcept
 	return _tick_group;
 }
 
+BehaviorId Component::start_behavior(Behavior&& behavior)
+{
+	return owner().start_behavior(std::move(behavior));
+}
+
 Entity& Component::owner() noexcept
 {
 	const Component* const_this = this;
@@ -21,15 +28,15 @@ Entity& Component::owner() noexcept
 
 const Entity& Component::owner() const noexcept
 {
-	const peng::shared_ptr<Entity> owner_locked = _owner.lock();
+	const Entity* owner = _owner.get();
 
 	// If the owner is no longer valid then something has gone wrong
 	// as the component should never outlive the owner
-	check(owner_locked);
-	return *owner_locked.get();
+	check(owner);
+	return *owner;
 }
 
-void Component::set_owner(peng::shared_ref<Entity>&& entity)
+void Component::set_owner(EntityHandle<Entity> entity)
 {
 	if (_owner.valid() && _owner != entity)
 	{
@@ -1,8 +1,11 @@
 #pragma once
 
-#include <memory/weak_ptr.h>
+#include <memory/enable_shared_from_this.h>
+
+#include "entity_handle.h"
 
 #include "tickable.h"
+#include "behavior.h"
 #include "serializable.h"
 #include "component_definition.h"
 
@@ -11,7 +14,7 @@ class Entity;
 class Component :
     public ITickable,
     public Serializable,
-    public std::enable_shared_from_this<Component>
+    public peng::enable_shared_from_this<Component>
 {
 	friend Entity;
 
@@ -28,12 +31,20 @@ public:
 	virtual void post_create() { }
 	virtual void pre_destroy() { }
 
+	// Runs a coroutine behavior on behalf of the owner, see Entity::start_behavior
+	// Can only be used once the component has been created
+	BehaviorId start_behavior(Behavior&& behavior);
+
 	[[nodiscard]] Entity& owner() noexcept;
 	[[nodiscard]] const Entity& owner() const noexcept;
 
+	// Whether the owner added this component from its own constructor or post_create
+	[[nodiscard]] bool created_by_owner() const noexcept { return _created_by_owner; }
+
 private:
-	void set_owner(peng::shared_ref<Entity>&& entity);
+	void set_owner(EntityHandle<Entity> entity);
 
 	TickGroup _tick_group;
-	peng::weak_ptr<Entity> _owner;
+	EntityHandle<Entity> _owner;
+	bool _created_by_owner;
 };
\ No newline at end of file
@@ -11,12 +11,12 @@ public: \
 	\
 	[[nodiscard]] peng::weak_ptr<ComponentType> weak_this() \
 	{ \
-		return peng::weak_ptr<ComponentType>(std::static_pointer_cast<ComponentType>(shared_from_this())); \
+		return peng::static_pointer_cast<ComponentType>(weak_from_this()); \
 	} \
 	\
 	[[nodiscard]] peng::weak_ptr<const ComponentType> weak_this() const \
 	{ \
-		return peng::weak_ptr<const ComponentType>(std::static_pointer_cast<const ComponentType>(shared_from_this())); \
+		return peng::static_pointer_cast<const ComponentType>(weak_from_this()); \
 	} \
 private: \
 	static core::detail::ComponentDefinitionBootstrap<ComponentType> _component_bootstrap
@@ -0,0 +1,17 @@
+#include "component_type_id.h"
+
+#include <atomic>
+
+#include <utils/check.h>
+
+ComponentTypeId core::detail::allocate_component_type_id()
+{
+	// Function local so that ids can safely be allocated during static initialization
+	// Atomic as the first request for a type's id may come from any thread
+	static std::atomic<ComponentTypeId> next_id = 0;
+
+	const ComponentTypeId id = next_id.fetch_add(1, std::memory_order_relaxed);
+	check(id < max_component_types);
+
+	return id;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+
+class Component;
+
+using ComponentTypeId = uint16_t;
+
+// Upper bound on the number of distinct component types, sets the width of component masks
+constexpr size_t max_component_types = 128;
+
+using ComponentMask = std::bitset<max_component_types>;
+
+namespace core::detail
+{
+	[[nodiscard]] ComponentTypeId allocate_component_type_id();
+}
+
+// Dense id of a component type, assigned the first time it is requested
+// Ids are only stable within a single run so must never be serialized
+template <typename T>
+[[nodiscard]] ComponentTypeId component_type_id()
+{
+	static const ComponentTypeId id = core::detail::allocate_component_type_id();
+	return id;
+}
@@ -1,11 +1,18 @@
 #pragma once
 
 #include <core/component_factory.h>
+#include <core/component_type_id.h>
 
 #include "reflection_bootstrap.h"
 
+class Component;
+
 namespace core::detail
 {
+	// If T provides its own tick rather than inheriting the empty Component::tick
+	template <typename T>
+	constexpr bool component_has_tick = !std::is_same_v<decltype(&T::tick), void (Component::*)(float)>;
+
 	template <typename T>
 	class ComponentDefinitionBootstrap
 	{
@@ -20,7 +27,7 @@ namespace core::detail
 
 	template <typename T>
 	ComponentDefinitionBootstrap<T>::ComponentDefinitionBootstrap(const std::string& type_name)
-		: _reflection_bootstrap(type_name)
+		: _reflection_bootstrap(type_name, component_has_tick<T>, component_type_id<T>())
 	{
 		if constexpr (!std::is_abstract_v<T>)
 		{
@@ -4,8 +4,14 @@
 
 #include "reflection_bootstrap.h"
 
+class Entity;
+
 namespace core::detail
 {
+	// If T provides its own tick rather than inheriting Entity::tick, which does no work
+	template <typename T>
+	constexpr bool entity_has_tick = !std::is_same_v<decltype(&T::tick), void (Entity::*)(float)>;
+
 	template <typename T>
 	class EntityDefinitionBootstrap
 	{
@@ -20,7 +26,7 @@ namespace core::detail
 
 	template <typename T>
 	EntityDefinitionBootstrap<T>::EntityDefinitionBootstrap(const std::string& type_name)
-		: _reflection_bootstrap(type_name)
+		: _reflection_bootstrap(type_name, entity_has_tick<T>)
 	{
 		if constexpr (!std::is_abstract_v<T>)
 		{
@@ -10,21 +10,28 @@ namespace core::detail
 	class ReflectionBootstrap
 	{
 	public:
-		ReflectionBootstrap(const std::string& type_name);
+		ReflectionBootstrap(const std::string& type_name, bool has_tick = true, int32_t component_id = -1);
 		ReflectionBootstrap(const ReflectionBootstrap&) = delete;
 		ReflectionBootstrap(ReflectionBootstrap&&) = delete;
 	};
 
 	template <typename T>
-	ReflectionBootstrap<T>::ReflectionBootstrap(const std::string& type_name)
+	ReflectionBootstrap<T>::ReflectionBootstrap(const std::string& type_name, bool has_tick, int32_t component_id)
 	{
 		Logger::log("Registering reflection information for '%s'", type_name.c_str());
 
 		ReflectedType type;
 		type.is_abstract = std::is_abstract_v<T>;
+		type.has_tick = has_tick;
+		type.component_id = component_id;
 		type.name = type_name;
 		type.info = &typeid(T);
 
+		if constexpr (requires { { T::tick_access } -> std::convertible_to<TickAccess>; })
+		{
+			type.tick_access = T::tick_access;
+		}
+
 		ReflectionDatabase::get().register_type(type);
 	}
 }
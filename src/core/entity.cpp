@@ -4,18 +4,30 @@
 
 #include "serialized_member.h"
 #include "entity_subsystem.h"
+#include "timer_subsystem.h"
 #include "component.h"
+#include "prefab.h"
 
 IMPLEMENT_ENTITY(Entity);
 
 Entity::Entity(std::string&& name, TickGroup tick_group)
 	: _name(std::move(name))
 	, _tick_group(tick_group)
+	, _state(EntityState::invalid)
     , _constructed(false)
 	, _created(false)
+	, _creating(true)
+	, _created_by_parent(false)
 	, _active_self(true)
 	, _active_hierarchy(true)
+	, _physics_interpolated(false)
+	, _render_interpolated(false)
 	, _parent_relationship(EntityRelationship::full)
+	, _world_matrix_valid(false)
+	, _world_matrix_inv_valid(false)
+	, _archetype(nullptr)
+	, _archetype_index(-1)
+	, _pending_refresh(EntityRefresh::none)
 {
 	SERIALIZED_MEMBER(_local_transform, "transform");
 }
@@ -43,7 +55,7 @@ void Entity::post_create()
 
 	for (const peng::shared_ref<Component>& component : _deferred_components)
 	{
-		component->set_owner(peng::shared_ref(shared_from_this()));
+		component->set_owner(_handle);
 		component->post_create();
 	}
 
@@ -52,16 +64,39 @@ void Entity::post_create()
 
 void Entity::pre_destroy()
 {
-	set_active(false);
+	// When the whole world is cleared every entity is going away together,
+	// so there is no need to maintain activity or the hierarchy
+	const bool clearing_world = EntitySubsystem::get().clearing_world();
+
+	if (!clearing_world)
+	{
+		set_active(false);
+	}
 
 	for (const peng::shared_ref<Component>& component : _components)
 	{
 		component->pre_destroy();
 	}
 
-	if (_parent)
+	BehaviorScheduler& behavior_scheduler = EntitySubsystem::get().behavior_scheduler();
+	for (const BehaviorId behavior : _behaviors)
+	{
+		behavior_scheduler.stop(behavior);
+	}
+
+	_behaviors.clear();
+
+	TimerSubsystem& timer_subsystem = TimerSubsystem::get();
+	for (const TimerHandle timer : _timers)
 	{
-		vectools::remove(_parent->_children, weak_this());
+		timer_subsystem.cancel(timer);
+	}
+
+	_timers.clear();
+
+	if (_parent && !clearing_world)
+	{
+		vectools::remove(_parent->_children, _handle);
 	}
 }
 
@@ -76,8 +111,35 @@ void Entity::set_active(bool active)
 	propagate_active_change(true);
 }
 
-void Entity::set_parent(const peng::weak_ptr<Entity>& parent, EntityRelationship relationship)
+void Entity::set_physics_interpolated(bool interpolated)
 {
+	if (interpolated == _physics_interpolated)
+	{
+		return;
+	}
+
+	_physics_interpolated = interpolated;
+
+	PhysicsInterpolator& interpolator = EntitySubsystem::get()._physics_interpolator;
+	if (_physics_interpolated)
+	{
+		interpolator.add(*this);
+	}
+	else
+	{
+		interpolator.remove(*this);
+	}
+}
+
+void Entity::set_parent(EntityHandle<Entity> parent, EntityRelationship relationship)
+{
+	EntitySubsystem& entity_subsystem = EntitySubsystem::get();
+	if (entity_subsystem.recording_commands())
+	{
+		entity_subsystem._commands.record_set_parent(weak_this().lock(), parent.to_weak_ptr().lock(), relationship);
+		return;
+	}
+
 	const bool was_active_hierarchy = _active_hierarchy;
 
 	if (parent == _parent && relationship == _parent_relationship)
@@ -87,23 +149,32 @@ void Entity::set_parent(const peng::weak_ptr<Entity>& parent, EntityRelationship
 
 	if (_parent.valid())
 	{
-		vectools::remove(_parent->_children, weak_this());
+		vectools::remove(_parent->_children, _handle);
 		_active_hierarchy = _active_self;
 	}
 
 	_parent = parent;
 	_parent_relationship = relationship;
+	_created_by_parent = _parent.valid() && _parent->creating_self();
+	invalidate_world_transform();
+	EntitySubsystem::get().mark_hierarchy_dirty();
 
 	if (_parent.valid())
 	{
-		_parent->_children.push_back(weak_this());
+		_parent->_children.push_back(_handle);
 		_active_hierarchy = has_activity_parent()
 			? _active_self && _parent->active_in_hierarchy()
 			: _active_self;
 	}
 
+	if (_active_hierarchy != was_active_hierarchy && _created)
+	{
+		EntitySubsystem::get().queue_refresh(*this, EntityRefresh::tickables);
+	}
+
 	if (_active_hierarchy && !was_active_hierarchy)
 	{
+		unpark_behaviors();
 		post_enable();
 	}
 	else if (!_active_hierarchy && was_active_hierarchy)
@@ -112,19 +183,69 @@ void Entity::set_parent(const peng::weak_ptr<Entity>& parent, EntityRelationship
 	}
 }
 
-void Entity::add_child(const peng::weak_ptr<Entity>& child, EntityRelationship relationship)
+void Entity::add_child(EntityHandle<Entity> child, EntityRelationship relationship)
 {
-	child->set_parent(weak_this(), relationship);
+	child->set_parent(_handle, relationship);
 }
 
 void Entity::destroy()
 {
-	for (const peng::weak_ptr<Entity>& child : _children)
+	// Children are queued by the entity subsystem
+	EntitySubsystem::get().destroy_entity(weak_this());
+}
+
+BehaviorId Entity::start_behavior(Behavior&& behavior)
+{
+	BehaviorScheduler& behavior_scheduler = EntitySubsystem::get().behavior_scheduler();
+
+	// Ids of behaviors that have since finished are pruned so the list doesn't grow over the lifetime of the entity
+	vectools::remove_all<BehaviorId>(_behaviors, [&](const BehaviorId& id)
 	{
-		child->destroy();
-	}
+		return !behavior_scheduler.running(id);
+	});
 
-	EntitySubsystem::get().destroy_entity(weak_this());
+	const BehaviorId id = behavior_scheduler.start(std::move(behavior), _handle);
+	_behaviors.push_back(id);
+
+	return id;
+}
+
+void Entity::stop_behavior(BehaviorId id)
+{
+	EntitySubsystem::get().behavior_scheduler().stop(id);
+}
+
+TimerHandle Entity::after(float seconds, TimerWheel::Callback&& callback)
+{
+	TimerSubsystem& timer_subsystem = TimerSubsystem::get();
+	vectools::remove_all<TimerHandle>(_timers, [&](const TimerHandle& timer)
+	{
+		return !timer_subsystem.pending(timer);
+	});
+
+	const TimerHandle timer = timer_subsystem.after(seconds, std::move(callback));
+	_timers.push_back(timer);
+
+	return timer;
+}
+
+TimerHandle Entity::every(float interval, TimerWheel::Callback&& callback)
+{
+	TimerSubsystem& timer_subsystem = TimerSubsystem::get();
+	vectools::remove_all<TimerHandle>(_timers, [&](const TimerHandle& timer)
+	{
+		return !timer_subsystem.pending(timer);
+	});
+
+	const TimerHandle timer = timer_subsystem.every(interval, std::move(callback));
+	_timers.push_back(timer);
+
+	return timer;
+}
+
+peng::weak_ptr<Entity> Entity::clone() const
+{
+	return Prefab::from_entity(*this)->instantiate();
 }
 
 peng::weak_ptr<Entity> Entity::load_entity(const Archive& archive)
@@ -142,15 +263,18 @@ peng::weak_ptr<Entity> Entity::load_child(const Archive& archive, EntityRelation
 
 peng::weak_ptr<Component> Entity::get_component(const peng::shared_ref<const ReflectedType>& component_type)
 {
-	for (const peng::shared_ref<Component>& component : _components)
+	if (component_type->component_id < 0)
 	{
-		if (component->type() == component_type)
-		{
-			return component;
-		}
+		return {};
 	}
 
-	return {};
+	const int32_t slot = component_slot(static_cast<ComponentTypeId>(component_type->component_id));
+	if (slot < 0)
+	{
+		return recorded_component(static_cast<ComponentTypeId>(component_type->component_id));
+	}
+
+	return _components[slot];
 }
 
 peng::weak_ptr<Component> Entity::get_component_in_children(
@@ -161,7 +285,7 @@ peng::weak_ptr<Component> Entity::get_component_in_children(
 		return component;
 	}
 
-	for (const peng::weak_ptr<Entity>& child : _children)
+	for (const EntityHandle<Entity>& child : _children)
 	{
 		if (peng::weak_ptr<Component> component = child->get_component(component_type))
 		{
@@ -183,6 +307,17 @@ peng::weak_ptr<const Component> Entity::get_component_in_children(
 	return const_cast<Entity*>(this)->get_component_in_children(component_type);
 }
 
+bool Entity::has_component(const ReflectedType& component_type) const noexcept
+{
+	if (component_type.component_id < 0)
+	{
+		return false;
+	}
+
+	const ComponentTypeId component_id = static_cast<ComponentTypeId>(component_type.component_id);
+	return _component_mask.test(component_id) || recorded_component(component_id).valid();
+}
+
 bool Entity::has_parent() const noexcept
 {
 	return _parent.valid();
@@ -198,28 +333,61 @@ bool Entity::has_activity_parent() const noexcept
 	return has_parent() && (_parent_relationship & EntityRelationship::activity) == EntityRelationship::activity;
 }
 
-math::Matrix4x4f Entity::transform_matrix() const noexcept
+const math::Matrix4x4f& Entity::transform_matrix() const noexcept
 {
-	const math::Matrix4x4f local_matrix = _local_transform.to_matrix();
+	if (!_world_matrix_valid)
+	{
+		_world_matrix = matrix_transform().to_matrix();
+		if (has_spatial_parent())
+		{
+			_world_matrix = math::multiply(_parent->transform_matrix(), _world_matrix);
+		}
 
-	if (has_spatial_parent())
+		_world_matrix_valid = true;
+	}
+
+	return _world_matrix;
+}
+
+const math::Matrix4x4f& Entity::transform_matrix_inv() const noexcept
+{
+	if (!_world_matrix_inv_valid)
 	{
-		return _parent->transform_matrix() * local_matrix;
+		_world_matrix_inv = matrix_transform().to_inverse_matrix();
+		if (has_spatial_parent())
+		{
+			_world_matrix_inv = _world_matrix_inv * _parent->transform_matrix_inv();
+		}
+
+		_world_matrix_inv_valid = true;
 	}
 
-	return local_matrix;
+	return _world_matrix_inv;
 }
 
-math::Matrix4x4f Entity::transform_matrix_inv() const noexcept
+math::Transform& Entity::local_transform() noexcept
 {
-	const math::Matrix4x4f local_matrix_inv = _local_transform.to_inverse_matrix();
+	// Invalidating the hierarchy would race with other instances of the same type moving our parent or children
+	check(!TickScheduler::ticking_instances_concurrently());
+	_render_interpolated = false;
+	invalidate_world_transform();
+	return _local_transform;
+}
 
-	if (has_spatial_parent())
+void Entity::set_interpolated_transform(const math::Transform& transform) noexcept
+{
+	_interpolated_transform = transform;
+	_render_interpolated = true;
+	invalidate_world_transform();
+}
+
+void Entity::clear_interpolated_transform() noexcept
+{
+	if (_render_interpolated)
 	{
-		return local_matrix_inv * _parent->transform_matrix_inv();
+		_render_interpolated = false;
+		invalidate_world_transform();
 	}
-
-	return local_matrix_inv;
 }
 
 math::Vector3f Entity::world_position() const noexcept
@@ -232,13 +400,108 @@ math::Vector3f Entity::world_position() const noexcept
 	return _local_transform.position;
 }
 
+void Entity::invalidate_world_transform() noexcept
+{
+	// Only the entity the invalidation starts from is marked, the transform system rebuilds its children with it
+	if (_world_matrix_valid && _handle)
+	{
+		EntitySubsystem::get().mark_transform_dirty(*this);
+	}
+
+	invalidate_world_transform_recursive();
+}
+
+void Entity::invalidate_world_transform_recursive() noexcept
+{
+	// A cache can only be valid if the same cache of the parent was valid when it was built,
+	// so if neither is valid then all of our spatial children must already be invalid too
+	if (!_world_matrix_valid && !_world_matrix_inv_valid)
+	{
+		return;
+	}
+
+	_world_matrix_valid = false;
+	_world_matrix_inv_valid = false;
+
+	for (const EntityHandle<Entity>& child : _children)
+	{
+		if (child && child->has_spatial_parent())
+		{
+			child->invalidate_world_transform_recursive();
+		}
+	}
+}
+
+void Entity::unpark_behaviors()
+{
+	BehaviorScheduler& behavior_scheduler = EntitySubsystem::get().behavior_scheduler();
+	for (const BehaviorId behavior : _behaviors)
+	{
+		behavior_scheduler.unpark(behavior);
+	}
+}
+
+void Entity::attach_component(const peng::shared_ref<Component>& component, ComponentTypeId component_id)
+{
+	_components.push_back(component);
+	register_component_slot(component_id);
+
+	if (_constructed)
+	{
+		component->set_owner(_handle);
+	}
+
+	if (_created)
+	{
+		component->post_create();
+
+		const EntityRefresh refresh = _archetype
+			? EntityRefresh::tickables | EntityRefresh::queries | EntityRefresh::archetype
+			: EntityRefresh::tickables | EntityRefresh::queries;
+
+		EntitySubsystem::get().queue_refresh(*this, refresh);
+	}
+	else
+	{
+		_deferred_components.push_back(component);
+	}
+}
+
+peng::weak_ptr<Component> Entity::recorded_component(ComponentTypeId component_id) const noexcept
+{
+	const EntitySubsystem& entity_subsystem = EntitySubsystem::get();
+	if (!entity_subsystem.recording_commands())
+	{
+		return {};
+	}
+
+	return entity_subsystem._commands.find_recorded_component(*this, component_id);
+}
+
+void Entity::register_component_slot(ComponentTypeId component_id)
+{
+	// Only the first component of each type is indexed, matching the order lookups used to scan in
+	if (_component_mask.test(component_id))
+	{
+		return;
+	}
+
+	if (_component_slots.size() <= component_id)
+	{
+		_component_slots.resize(component_id + 1, -1);
+	}
+
+	_component_slots[component_id] = static_cast<int32_t>(_components.size() - 1);
+	_component_mask.set(component_id);
+}
+
 void Entity::propagate_active_change(bool parent_active)
 {
 	const bool new_active = parent_active && _active_self;
 	const bool require_enable = new_active && !_active_hierarchy;
 	const bool require_disable = !new_active && _active_hierarchy;
 
-	for (const peng::weak_ptr<Entity>& child : _children)
+	for (const EntityHandle<Entity>& child : _children)
 	{
 		if (child && child->has_activity_parent())
 		{
@@ -247,8 +510,14 @@ void Entity::propagate_active_change(bool parent_active)
 	}
 
 	_active_hierarchy = new_active;
+	if ((require_enable || require_disable) && _created)
+	{
+		EntitySubsystem::get().queue_refresh(*this, EntityRefresh::tickables);
+	}
+
 	if (require_enable)
 	{
+		unpark_behaviors();
 		post_enable();
 	}
 	else if (require_disable)
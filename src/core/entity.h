@@ -3,26 +3,36 @@
 #include <vector>
 #include <memory>
 
-#include <memory/weak_ptr.h>
+#include <memory/enable_shared_from_this.h>
+#include <memory/pool_allocator.h>
 #include <math/transform.h>
 
 #include "tickable.h"
 #include "serializable.h"
 #include "entity_relationship.h"
 #include "entity_definition.h"
+#include "component_type_id.h"
+#include "behavior.h"
+#include "timer_wheel.h"
 
 class Component;
+class Archetype;
+class ArchetypeStorage;
+class TransformSystem;
+class PhysicsInterpolator;
 
-// TODO: using weak_ptr for entity handle has bad -> performance due to lock
-//       investigate alternative solutions
 class Entity :
     public ITickable,
     public Serializable,
-    public std::enable_shared_from_this<Entity>
+    public peng::enable_shared_from_this<Entity>
 {
 	DECLARE_ENTITY(Entity);
 
 	friend EntitySubsystem;
+	friend Archetype;
+	friend ArchetypeStorage;
+	friend TransformSystem;
+	friend PhysicsInterpolator;
 
 public:
 	explicit Entity(std::string&& name, TickGroup tick_group = TickGroup::standard);
@@ -39,12 +49,30 @@ public:
 	virtual void post_enable() { }
 	virtual void post_disable() { }
 
+	// Must not be called from a parallel tick group, activity changes aren't recorded as commands
 	void set_active(bool active);
-	void set_parent(const peng::weak_ptr<Entity>& parent, EntityRelationship relationship = EntityRelationship::full);
-	void add_child(const peng::weak_ptr<Entity>& child, EntityRelationship relationship = EntityRelationship::full);
+
+	// Blends the transform between the last two physics steps when rendering, for entities moved by the physics group
+	// Must be called from the main thread
+	void set_physics_interpolated(bool interpolated);
+	void set_parent(EntityHandle<Entity> parent, EntityRelationship relationship = EntityRelationship::full);
+	void add_child(EntityHandle<Entity> child, EntityRelationship relationship = EntityRelationship::full);
 	void destroy();
 
-	// TODO: add a way to clone entities
+	// Runs a coroutine behavior until it finishes, is stopped or this entity is destroyed
+	// Behaviors don't resume while the entity is inactive, and must be started from the main thread
+	BehaviorId start_behavior(Behavior&& behavior);
+	void stop_behavior(BehaviorId id);
+
+	// Schedules a timer on the timer subsystem that is cancelled when this entity is destroyed
+	TimerHandle after(float seconds, TimerWheel::Callback&& callback);
+	TimerHandle every(float interval, TimerWheel::Callback&& callback);
+
+	// Creates a copy of this entity, its components and its children
+	// The copy has no parent, returns nullptr if the copy could not be created
+	// Children and components the entity creates for itself are recreated by the copy rather than copied,
+	// their member values are only copied for components created by the constructor
+	[[nodiscard]] peng::weak_ptr<Entity> clone() const;
 
 	template <std::derived_from<Entity> T, typename...Args>
 	requires std::constructible_from<T, Args...>
@@ -86,6 +114,11 @@ public:
 	template <std::derived_from<Component> T>
 	[[nodiscard]] peng::weak_ptr<const T> get_component_in_children() const;
 
+	// Only matches components of exactly the given type, checking the component mask of the entity
+	template <std::derived_from<Component> T>
+	[[nodiscard]] bool has_component() const noexcept;
+	[[nodiscard]] bool has_component(const ReflectedType& component_type) const noexcept;
+
 	template <std::derived_from<Entity> T>
 	[[nodiscard]] bool is_type() const;
 
@@ -98,21 +131,37 @@ public:
 	[[nodiscard]] const std::string& name() const noexcept { return _name; }
 	[[nodiscard]] bool active_in_hierarchy() const noexcept { return _active_hierarchy; }
 	[[nodiscard]] bool active_self() const noexcept { return _active_self; }
+	[[nodiscard]] EntityState state() const noexcept { return _state; }
+	[[nodiscard]] bool physics_interpolated() const noexcept { return _physics_interpolated; }
+
+	[[nodiscard]] EntityHandle<Entity> handle() noexcept { return _handle; }
+	[[nodiscard]] EntityHandle<const Entity> handle() const noexcept { return _handle; }
 
-	[[nodiscard]] peng::weak_ptr<Entity> parent() noexcept { return _parent; }
-	[[nodiscard]] peng::weak_ptr<const Entity> parent() const noexcept { return _parent; }
-	[[nodiscard]] const std::vector<peng::weak_ptr<Entity>>& children() const noexcept { return _children; }
+	[[nodiscard]] EntityHandle<Entity> parent() noexcept { return _parent; }
+	[[nodiscard]] EntityHandle<const Entity> parent() const noexcept { return _parent; }
+	[[nodiscard]] const std::vector<EntityHandle<Entity>>& children() const noexcept { return _children; }
+	[[nodiscard]] EntityRelationship parent_relationship() const noexcept { return _parent_relationship; }
 
 	[[nodiscard]] bool has_parent() const noexcept;
 	[[nodiscard]] bool has_spatial_parent() const noexcept;
 	[[nodiscard]] bool has_activity_parent() const noexcept;
 
-	[[nodiscard]] math::Matrix4x4f transform_matrix() const noexcept;
-	[[nodiscard]] math::Matrix4x4f transform_matrix_inv() const noexcept;
-	[[nodiscard]] math::Transform& local_transform() noexcept { return _local_transform; }
+	// World matrices are cached and only rebuilt after this entity or a spatial parent has moved
+	// Physics interpolated entities build them from the blended transform between frames, their local transform stays simulated
+	// Invalidated matrices are rebuilt in bulk by the transform system before the render_parallel group
+	// The inverse is built lazily on first use so shouldn't be queried from concurrent ticks
+	[[nodiscard]] const math::Matrix4x4f& transform_matrix() const noexcept;
+	[[nodiscard]] const math::Matrix4x4f& transform_matrix_inv() const noexcept;
+
+	// Mutable access invalidates the cached world matrices of this entity and its spatial children
+	// For physics interpolated entities it also stops blending until the next physics steps, so the write shows up straight away
+	[[nodiscard]] math::Transform& local_transform() noexcept;
 	[[nodiscard]] const math::Transform& local_transform() const noexcept { return _local_transform; }
 	[[nodiscard]] const std::vector<peng::shared_ref<Component>>& components() const noexcept { return _components; }
 
+	// Whether the parent created this entity from its own constructor or post_create
+	[[nodiscard]] bool created_by_parent() const noexcept { return _created_by_parent; }
+
 	[[nodiscard]] math::Vector3f world_position() const noexcept;
 	// TODO: implement world_rotation
 	// TODO: implement world_scale
@@ -121,24 +170,77 @@ public:
 	// TODO: implement world_right
 
 protected:
-	std::string _name;
+	// Entities are indexed by name once registered, so the name can never change
+	const std::string _name;
 	TickGroup _tick_group;
-	math::Transform _local_transform;
 
 private:
 	void propagate_active_change(bool parent_active);
 
+	// Requeues the behaviors that came due while the entity was inactive
+	void unpark_behaviors();
+
+	void attach_component(const peng::shared_ref<Component>& component, ComponentTypeId component_id);
+
+	// Indexes a newly added component so that typed lookups don't need to scan the component list
+	void register_component_slot(ComponentTypeId component_id);
+
+	// Index into _components of the first component with exactly the given type, or -1
+	[[nodiscard]] int32_t component_slot(ComponentTypeId component_id) const noexcept
+	{
+		return _component_mask.test(component_id) ? _component_slots[component_id] : -1;
+	}
+
+	// Component of the type that the calling thread added while ticking concurrently, which isn't attached until the next flush
+	[[nodiscard]] peng::weak_ptr<Component> recorded_component(ComponentTypeId component_id) const noexcept;
+	void invalidate_world_transform() noexcept;
+	void invalidate_world_transform_recursive() noexcept;
+
+	// The transform the world matrices are built from
+	[[nodiscard]] const math::Transform& matrix_transform() const noexcept
+	{
+		return _render_interpolated ? _interpolated_transform : _local_transform;
+	}
+
+	// Builds the world matrices from the blended physics transform rather than the local transform
+	void set_interpolated_transform(const math::Transform& transform) noexcept;
+	void clear_interpolated_transform() noexcept;
+
+	// True while the entity's own constructor or post_create is running
+	[[nodiscard]] bool creating_self() const noexcept { return _creating; }
+
+	EntityState _state;
 	bool _constructed;
 	bool _created;
+	bool _creating;
+	bool _created_by_parent;
 	bool _active_self;
 	bool _active_hierarchy;
+	bool _physics_interpolated;
+	bool _render_interpolated;
 
-	peng::weak_ptr<Entity> _parent;
+	EntityHandle<Entity> _handle;
+	EntityHandle<Entity> _parent;
 	EntityRelationship _parent_relationship;
 
-	std::vector<peng::weak_ptr<Entity>> _children;
+	std::vector<EntityHandle<Entity>> _children;
 	std::vector<peng::shared_ref<Component>> _components;
 	std::vector<peng::shared_ref<Component>> _deferred_components;
+	std::vector<int32_t> _component_slots;
+	ComponentMask _component_mask;
+	std::vector<BehaviorId> _behaviors;
+	std::vector<TimerHandle> _timers;
+
+	math::Transform _local_transform;
+	math::Transform _interpolated_transform;
+	mutable math::Matrix4x4f _world_matrix;
+	mutable math::Matrix4x4f _world_matrix_inv;
+	mutable bool _world_matrix_valid;
+	mutable bool _world_matrix_inv_valid;
+
+	Archetype* _archetype;
+	int32_t _archetype_index;
+	EntityRefresh _pending_refresh;
 };
 
 template <std::derived_from<Entity> T, typename...Args>
@@ -160,7 +262,17 @@ requires std::constructible_from<T, Args...>
 peng::weak_ptr<T> Entity::create_child(Args&&... args)
 {
 	peng::weak_ptr<T> entity = create_entity<T>(std::forward<Args>(args)...);
-	add_child(entity, R);
+
+	// Entities created while ticking concurrently have no handle until the next flush
+	EntitySubsystem& entity_subsystem = EntitySubsystem::get();
+	if (entity_subsystem.recording_commands())
+	{
+		entity_subsystem._commands.record_set_parent(entity.lock(), weak_this().lock(), R);
+	}
+	else
+	{
+		add_child(entity, R);
+	}
 
 	return entity;
 }
@@ -168,21 +280,21 @@ peng::weak_ptr<T> Entity::create_child(Args&&... args)
 template <std::derived_from<Component> T, typename...Args>
 peng::weak_ptr<T> Entity::add_component(Args&&...args)
 {
-	peng::shared_ref<T> component = peng::make_shared<T>(std::forward<Args>(args)...);
-	_components.push_back(component);
-
-	if (_constructed)
-	{
-		component->set_owner(peng::shared_ref(shared_from_this()));
-	}
-
-	if (_created)
+	// Components of the same type are pooled together for locality when ticking
+	const memory::PoolAllocator<T> allocator(memory::PoolRegistry::pool<T>());
+	peng::shared_ref<T> component = peng::allocate_shared<T>(allocator, std::forward<Args>(args)...);
+	component->_created_by_owner = creating_self();
+
+	// Registered entities may be read by other threads while ticking concurrently
+	// so the component is only attached at the next flush, lookups from this thread still find it meanwhile
+	EntitySubsystem& entity_subsystem = EntitySubsystem::get();
+	if (_constructed && entity_subsystem.recording_commands())
 	{
-		component->post_create();
+		entity_subsystem._commands.record_attach_component(weak_this().lock(), component, component_type_id<T>());
 	}
 	else
 	{
-		_deferred_components.push_back(component);
+		attach_component(component, component_type_id<T>());
 	}
 
 	return component;
@@ -203,9 +315,13 @@ peng::weak_ptr<T> Entity::require_component()
 template <std::derived_from<Component> T>
 peng::weak_ptr<T> Entity::get_component()
 {
-	const peng::shared_ref<const ReflectedType> reflected_type = ReflectionDatabase::get().reflect_type_checked<T>();
-	const peng::weak_ptr<Component> component = get_component(reflected_type);
-	return peng::weak_ptr<T>(std::static_pointer_cast<T>(component.lock().get_impl()));
+	const int32_t slot = component_slot(component_type_id<T>());
+	if (slot < 0)
+	{
+		return peng::static_pointer_cast<T>(recorded_component(component_type_id<T>()));
+	}
+
+	return peng::static_pointer_cast<T>(_components[slot]);
 }
 
 template <std::derived_from<Component> T>
@@ -219,7 +335,7 @@ peng::weak_ptr<T> Entity::get_component_in_children()
 {
 	const peng::shared_ref<const ReflectedType> reflected_type = ReflectionDatabase::get().reflect_type_checked<T>();
 	const peng::weak_ptr<Component> component = get_component_in_children(reflected_type);
-	return peng::weak_ptr<T>(std::static_pointer_cast<T>(component.lock().get_impl()));
+	return peng::static_pointer_cast<T>(component);
 }
 
 template <std::derived_from<Component> T>
@@ -228,6 +344,12 @@ peng::weak_ptr<const T> Entity::get_component_in_children() const
 	return const_cast<Entity*>(this)->get_component_in_children<T>();
 }
 
+template <std::derived_from<Component> T>
+bool Entity::has_component() const noexcept
+{
+	return _component_mask.test(component_type_id<T>()) || recorded_component(component_type_id<T>()).valid();
+}
+
 template <std::derived_from<Entity> T>
 bool Entity::is_type() const
 {
@@ -241,7 +363,7 @@ peng::weak_ptr<T> Entity::as_type()
 	const peng::shared_ref<const ReflectedType> reflected_type = ReflectionDatabase::get().reflect_type_checked<T>();
 	if (reflected_type == type())
 	{
-		return peng::weak_ptr<T>(std::static_pointer_cast<T>(shared_from_this()));
+		return peng::static_pointer_cast<T>(weak_from_this());
 	}
 
 	return {};
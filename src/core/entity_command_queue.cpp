@@ -0,0 +1,160 @@
+#include "entity_command_queue.h"
+
+#include <atomic>
+#include <algorithm>
+
+#include <utils/check.h>
+
+#include "entity.h"
+#include "component.h"
+
+static std::atomic<uint32_t> next_queue_id = 1;
+
+static thread_local uint64_t thread_issue_order = 0;
+
+// Buffer of the queue the calling thread most recently recorded into
+static thread_local uint32_t thread_queue_id = 0;
+static thread_local void* thread_buffer = nullptr;
+
+EntityCommandQueue::EntityCommandQueue()
+	: _id(next_queue_id++)
+	, _recording(false)
+{ }
+
+void EntityCommandQueue::begin_recording() noexcept
+{
+	check(!_recording);
+	_recording = true;
+}
+
+void EntityCommandQueue::end_recording() noexcept
+{
+	check(_recording);
+	_recording = false;
+}
+
+void EntityCommandQueue::set_issue_order(uint64_t order) noexcept
+{
+	thread_issue_order = order;
+}
+
+void EntityCommandQueue::record_register(const peng::shared_ref<Entity>& entity)
+{
+	record({
+		.type = EntityCommandType::register_entity,
+		.entity = entity
+	});
+}
+
+void EntityCommandQueue::record_destroy(const peng::shared_ptr<Entity>& entity)
+{
+	record({
+		.type = EntityCommandType::destroy_entity,
+		.entity = entity
+	});
+}
+
+void EntityCommandQueue::record_set_parent(
+	const peng::shared_ptr<Entity>& entity,
+	const peng::shared_ptr<Entity>& parent,
+	EntityRelationship relationship
+)
+{
+	record({
+		.type = EntityCommandType::set_parent,
+		.entity = entity,
+		.parent = parent,
+		.relationship = relationship
+	});
+}
+
+void EntityCommandQueue::record_attach_component(
+	const peng::shared_ptr<Entity>& entity,
+	const peng::shared_ref<Component>& component,
+	ComponentTypeId component_id
+)
+{
+	record({
+		.type = EntityCommandType::attach_component,
+		.entity = entity,
+		.component = component,
+		.component_id = component_id
+	});
+}
+
+peng::weak_ptr<Component> EntityCommandQueue::find_recorded_component(
+	const Entity& entity,
+	ComponentTypeId component_id
+) const noexcept
+{
+	if (thread_queue_id != _id)
+	{
+		return {};
+	}
+
+	for (const EntityCommand& command : static_cast<const ThreadBuffer*>(thread_buffer)->commands)
+	{
+		if (command.type == EntityCommandType::attach_component
+			&& command.entity.get() == &entity
+			&& command.component_id == component_id)
+		{
+			return command.component;
+		}
+	}
+
+	return {};
+}
+
+bool EntityCommandQueue::gather(std::vector<EntityCommand>& commands)
+{
+	check(!_recording);
+	commands.clear();
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : _buffers)
+	{
+		for (EntityCommand& command : buffer->commands)
+		{
+			commands.push_back(std::move(command));
+		}
+
+		buffer->commands.clear();
+	}
+
+	// A tickable only ever ticks on one thread, so commands sharing an order came from the same
+	// buffer and a stable sort keeps them in the order they were recorded
+	std::ranges::stable_sort(commands, {}, &EntityCommand::order);
+
+	return !commands.empty();
+}
+
+void EntityCommandQueue::clear()
+{
+	check(!_recording);
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : _buffers)
+	{
+		buffer->commands.clear();
+	}
+}
+
+void EntityCommandQueue::record(EntityCommand&& command)
+{
+	check(_recording);
+
+	command.order = thread_issue_order;
+	local_buffer().commands.push_back(std::move(command));
+}
+
+EntityCommandQueue::ThreadBuffer& EntityCommandQueue::local_buffer()
+{
+	if (thread_queue_id != _id)
+	{
+		// Only taken the first time a thread records, buffers are kept for the lifetime of the queue
+		std::scoped_lock lock(_buffers_lock);
+
+		thread_queue_id = _id;
+		thread_buffer = _buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+	}
+
+	return *static_cast<ThreadBuffer*>(thread_buffer);
+}
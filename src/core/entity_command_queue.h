@@ -0,0 +1,89 @@
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include <memory/shared_ptr.h>
+#include <memory/weak_ptr.h>
+
+#include "entity_relationship.h"
+#include "component_type_id.h"
+
+class Entity;
+class Component;
+
+enum class EntityCommandType
+{
+	register_entity,
+	destroy_entity,
+	set_parent,
+	attach_component
+};
+
+// Structural change recorded while entities were ticking concurrently, applied at the next flush
+struct EntityCommand
+{
+	EntityCommandType type = EntityCommandType::register_entity;
+
+	// Dispatch order of the tickable that issued the command within its tick group
+	uint64_t order = 0;
+
+	peng::shared_ptr<Entity> entity = {};
+	peng::shared_ptr<Entity> parent = {};
+	peng::shared_ptr<Component> component = {};
+	ComponentTypeId component_id = 0;
+	EntityRelationship relationship = EntityRelationship::full;
+};
+
+// Collects structural changes made while entities tick concurrently
+// Every thread records into its own buffer so recording never takes a lock once a thread has recorded once
+// Commands are merged in the dispatch order of the tickables that issued them, so the result
+// is the same as if the group had ticked sequentially regardless of how work was spread across threads
+class EntityCommandQueue
+{
+public:
+	EntityCommandQueue();
+	EntityCommandQueue(const EntityCommandQueue&) = delete;
+	EntityCommandQueue(EntityCommandQueue&&) = delete;
+
+	// Should only be called on the main thread outside of a concurrent wave
+	void begin_recording() noexcept;
+	void end_recording() noexcept;
+	[[nodiscard]] bool recording() const noexcept { return _recording; }
+
+	// Sets the dispatch order of the tickable about to tick on the calling thread
+	static void set_issue_order(uint64_t order) noexcept;
+
+	void record_register(const peng::shared_ref<Entity>& entity);
+	void record_destroy(const peng::shared_ptr<Entity>& entity);
+	void record_set_parent(const peng::shared_ptr<Entity>& entity, const peng::shared_ptr<Entity>& parent, EntityRelationship relationship);
+	void record_attach_component(const peng::shared_ptr<Entity>& entity, const peng::shared_ref<Component>& component, ComponentTypeId component_id);
+
+	// First component of the type that the calling thread has recorded attaching to the entity
+	// Buffers of other threads are still being written to, so only the caller's own recordings are found
+	[[nodiscard]] peng::weak_ptr<Component> find_recorded_component(const Entity& entity, ComponentTypeId component_id) const noexcept;
+
+	// Moves every recorded command into the output in a deterministic order
+	// Returns false if nothing was recorded
+	bool gather(std::vector<EntityCommand>& commands);
+
+	// Discards every recorded command
+	void clear();
+
+private:
+	struct ThreadBuffer
+	{
+		std::vector<EntityCommand> commands;
+	};
+
+	void record(EntityCommand&& command);
+	[[nodiscard]] ThreadBuffer& local_buffer();
+
+	uint32_t _id;
+	bool _recording;
+
+	std::mutex _buffers_lock;
+	std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "entity_handle.h"
 #include "detail/entity_definition_bootstrap.h"
 
 #define DECLARE_ENTITY(EntityType) \
@@ -11,12 +12,22 @@ public: \
 	\
 	[[nodiscard]] peng::weak_ptr<EntityType> weak_this() \
 	{ \
-		return peng::weak_ptr<EntityType>(std::static_pointer_cast<EntityType>(shared_from_this())); \
+		return peng::static_pointer_cast<EntityType>(weak_from_this()); \
 	} \
 	\
 	[[nodiscard]] peng::weak_ptr<const EntityType> weak_this() const \
 	{ \
-		return peng::weak_ptr<const EntityType>(std::static_pointer_cast<const EntityType>(shared_from_this())); \
+		return peng::static_pointer_cast<const EntityType>(weak_from_this()); \
+	} \
+	\
+	[[nodiscard]] EntityHandle<EntityType> handle_this() noexcept \
+	{ \
+		return static_handle_cast<EntityType>(handle()); \
+	} \
+	\
+	[[nodiscard]] EntityHandle<const EntityType> handle_this() const noexcept \
+	{ \
+		return static_handle_cast<const EntityType>(handle()); \
 	} \
 private: \
 	static core::detail::EntityDefinitionBootstrap<EntityType> _definition_bootstrap
@@ -121,6 +121,50 @@ void EntityFactory::load_components(const Archive& entity_archive, const peng::w
 	}
 }
 
+EntityRelationship EntityFactory::load_relationship(const Archive& child_archive)
+{
+	if (!child_archive.json_def.is_object())
+	{
+		return EntityRelationship::full;
+	}
+
+	const auto it = child_archive.json_def.find("relationship");
+	if (it == child_archive.json_def.end())
+	{
+		return EntityRelationship::full;
+	}
+
+	const auto parse_relationship = [&](const nlohmann::json& relationship_def)
+	{
+		const std::string relationship_name = relationship_def.is_string() ? relationship_def.get<std::string>() : "";
+
+		if (relationship_name == "full") { return EntityRelationship::full; }
+		if (relationship_name == "none") { return EntityRelationship::none; }
+		if (relationship_name == "spatial") { return EntityRelationship::spatial; }
+		if (relationship_name == "activity") { return EntityRelationship::activity; }
+
+		Logger::error(
+			"Unknown relationship '%s' on the entity '%s', falling back to full",
+			relationship_def.dump().c_str(), child_archive.name.c_str()
+		);
+
+		return EntityRelationship::full;
+	};
+
+	if (!it->is_array())
+	{
+		return parse_relationship(*it);
+	}
+
+	EntityRelationship relationship = EntityRelationship::none;
+	for (const auto& relationship_def : *it)
+	{
+		relationship = relationship | parse_relationship(relationship_def);
+	}
+
+	return relationship;
+}
+
 void EntityFactory::load_entity_children(const Archive& entity_archive, const peng::weak_ptr<Entity>& entity)
 {
 	if (const auto it = entity_archive.json_def.find("children"); it != entity_archive.json_def.end())
@@ -139,8 +183,7 @@ void EntityFactory::load_entity_children(const Archive& entity_archive, const pe
 
             if (const peng::weak_ptr<Entity> child = load_entity(child_archive))
 			{
-				// TODO: support serialized parent relationships other than full
-				child->set_parent(entity);
+				child->set_parent(entity, load_relationship(child_archive));
 			}
 		}
 	}
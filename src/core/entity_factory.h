@@ -6,6 +6,7 @@
 #include "item_factory.h"
 #include "reflection_database.h"
 #include "entity_subsystem.h"
+#include "entity_relationship.h"
 
 struct Archive;
 class Entity;
@@ -31,6 +32,10 @@ public:
 	// Returns nullptr if the load failed
 	peng::weak_ptr<Entity> load_entity(const Archive& archive);
 
+	// Reads the parent relationship of a child entity from its archive
+	// Accepts a single relationship name or an array of names, defaults to full
+	[[nodiscard]] static EntityRelationship load_relationship(const Archive& child_archive);
+
 private:
 	struct EntityConstructorSet
 	{
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <concepts>
+#include <functional>
+
+#include <memory/weak_ptr.h>
+#include <utils/check.h>
+
+#include "entity_slot_table.h"
+
+class Entity;
+class EntitySubsystem;
+
+// Compact, non-owning reference to an entity made up of a slot index and generation
+// Unlike weak_ptr, validity checks and dereferencing never touch a refcount and are O(1)
+// Handles become invalid once the entity has been killed by the entity subsystem
+template <typename T = Entity>
+class EntityHandle
+{
+	template <typename U>
+	friend class EntityHandle;
+
+	template <typename To, typename From>
+	friend EntityHandle<To> static_handle_cast(const EntityHandle<From>& handle) noexcept;
+
+	friend EntitySubsystem;
+
+public:
+	EntityHandle() noexcept
+		: _index(EntitySlotTable::invalid_index)
+		, _generation(0)
+	{ }
+
+	EntityHandle(std::nullptr_t) noexcept
+		: EntityHandle()
+	{ }
+
+	template <typename U>
+	requires std::convertible_to<U*, T*>
+	EntityHandle(const EntityHandle<U>& other) noexcept
+		: _index(other._index)
+		, _generation(other._generation)
+	{ }
+
+	template <typename U>
+	requires std::convertible_to<U*, T*>
+	EntityHandle(const peng::weak_ptr<U>& ptr)
+		: EntityHandle()
+	{
+		if (const peng::shared_ptr<U> locked = ptr.lock())
+		{
+			const auto handle = locked->handle();
+			_index = handle._index;
+			_generation = handle._generation;
+		}
+	}
+
+	template <typename U>
+	requires std::convertible_to<U*, T*>
+	EntityHandle(const peng::shared_ref<U>& ref)
+		: EntityHandle(peng::weak_ptr<U>(ref))
+	{ }
+
+	[[nodiscard]] T* get() const noexcept
+	{
+		return static_cast<T*>(EntitySlotTable::resolve(_index, _generation));
+	}
+
+	[[nodiscard]] T* operator->() const
+	{
+		T* entity = get();
+		check(entity);
+		return entity;
+	}
+
+	[[nodiscard]] T& operator*() const
+	{
+		return *operator->();
+	}
+
+	[[nodiscard]] bool valid() const noexcept
+	{
+		return get() != nullptr;
+	}
+
+	explicit operator bool() const noexcept
+	{
+		return valid();
+	}
+
+	// Creates a weak_ptr to the entity for use with APIs that require shared ownership semantics
+	[[nodiscard]] peng::weak_ptr<T> to_weak_ptr() const
+	{
+		if (T* entity = get())
+		{
+			return peng::static_pointer_cast<T>(entity->weak_from_this());
+		}
+
+		return {};
+	}
+
+	[[nodiscard]] uint32_t index() const noexcept { return _index; }
+	[[nodiscard]] uint32_t generation() const noexcept { return _generation; }
+
+private:
+	EntityHandle(uint32_t index, uint32_t generation) noexcept
+		: _index(index)
+		, _generation(generation)
+	{ }
+
+	uint32_t _index;
+	uint32_t _generation;
+};
+
+// Casts a handle to a derived entity type without checking the type of the entity
+template <typename To, typename From>
+[[nodiscard]] EntityHandle<To> static_handle_cast(const EntityHandle<From>& handle) noexcept
+{
+	return EntityHandle<To>(handle._index, handle._generation);
+}
+
+#pragma region Comparison Operators
+
+template <typename T, typename U>
+requires std::equality_comparable_with<T*, U*>
+[[nodiscard]] bool operator==(const EntityHandle<T>& a, const EntityHandle<U>& b) noexcept
+{
+	return a.index() == b.index() && a.generation() == b.generation();
+}
+
+#pragma endregion
+
+template<typename T>
+struct std::hash<EntityHandle<T>>
+{
+	size_t operator()(const EntityHandle<T>& handle) const noexcept
+	{
+		return std::hash<uint64_t>{}(static_cast<uint64_t>(handle.index()) << 32 | handle.generation());
+	}
+};
@@ -0,0 +1,216 @@
+#include "entity_index.h"
+
+#include <algorithm>
+
+#include <utils/check.h>
+
+#include "entity.h"
+#include "component.h"
+#include "reflection_database.h"
+
+void EntityIndexList::add(Entity& entity, std::span<Component* const> row_components)
+{
+	check(row_components.size() == stride);
+
+	if (const auto it = rows.find(&entity); it != rows.end())
+	{
+		std::ranges::copy(row_components, components.begin() + it->second * stride);
+		return;
+	}
+
+	rows.emplace(&entity, entities.size());
+	entities.push_back(&entity);
+	components.insert(components.end(), row_components.begin(), row_components.end());
+}
+
+void EntityIndexList::remove(const Entity& entity)
+{
+	const auto it = rows.find(&entity);
+	if (it == rows.end())
+	{
+		return;
+	}
+
+	// Swap the last row into the gap so that the lists stay dense
+	const size_t row = it->second;
+	const size_t last_row = entities.size() - 1;
+	rows.erase(it);
+
+	if (row != last_row)
+	{
+		entities[row] = entities[last_row];
+		std::copy_n(components.begin() + last_row * stride, stride, components.begin() + row * stride);
+		rows[entities[row]] = row;
+	}
+
+	entities.pop_back();
+	components.resize(last_row * stride);
+}
+
+void EntityIndex::add_entity(Entity& entity)
+{
+	_name_lists[entity.name()].add(entity);
+
+	for (const ReflectedType* type = entity.type().get(); type; type = resolve_base(type))
+	{
+		_type_lists[type].add(entity);
+	}
+
+	refresh_components(entity);
+}
+
+void EntityIndex::remove_entity(Entity& entity)
+{
+	if (const auto it = _name_lists.find(entity.name()); it != _name_lists.end())
+	{
+		it->second.remove(entity);
+		if (it->second.empty())
+		{
+			_name_lists.erase(it);
+		}
+	}
+
+	for (const ReflectedType* type = entity.type().get(); type; type = resolve_base(type))
+	{
+		if (const auto it = _type_lists.find(type); it != _type_lists.end())
+		{
+			it->second.remove(entity);
+		}
+	}
+
+	for (const auto& [key, view] : _views)
+	{
+		view->list.remove(entity);
+	}
+}
+
+void EntityIndex::refresh_components(Entity& entity)
+{
+	for (const auto& [key, view] : _views)
+	{
+		refresh_view(entity, *view);
+	}
+}
+
+void EntityIndex::clear()
+{
+	_name_lists.clear();
+	_type_lists.clear();
+	_views.clear();
+}
+
+const EntityIndexList* EntityIndex::find_by_name(const std::string& name) const
+{
+	if (const auto it = _name_lists.find(name); it != _name_lists.end())
+	{
+		return &it->second;
+	}
+
+	return nullptr;
+}
+
+const EntityIndexList* EntityIndex::find_by_type(const ReflectedType& type) const
+{
+	if (const auto it = _type_lists.find(&type); it != _type_lists.end())
+	{
+		return &it->second;
+	}
+
+	return nullptr;
+}
+
+const QueryView& EntityIndex::find_or_create_view(
+	std::type_index key,
+	std::vector<const ReflectedType*>&& types,
+	const std::vector<peng::shared_ref<Entity>>& entities
+)
+{
+	if (const auto it = _views.find(key); it != _views.end())
+	{
+		return *it->second;
+	}
+
+	std::unique_ptr<QueryView> view = std::make_unique<QueryView>();
+	view->types = std::move(types);
+	view->list.stride = view->types.size();
+
+	// Only a newly created view needs a full scan, afterwards it is kept up to date incrementally
+	for (const peng::shared_ref<Entity>& entity : entities)
+	{
+		refresh_view(*entity.get(), *view);
+	}
+
+	return *_views.emplace(key, std::move(view)).first->second;
+}
+
+const QueryView* EntityIndex::find_view(std::type_index key) const
+{
+	if (const auto it = _views.find(key); it != _views.end())
+	{
+		return it->second.get();
+	}
+
+	return nullptr;
+}
+
+bool EntityIndex::match_components(const Entity& entity, const QueryView& view)
+{
+	_component_buffer.clear();
+
+	for (const ReflectedType* query_type : view.types)
+	{
+		Component* match = nullptr;
+		for (const peng::shared_ref<Component>& component : entity.components())
+		{
+			if (derives_from(component->type().get(), query_type))
+			{
+				match = component.get();
+				break;
+			}
+		}
+
+		if (!match)
+		{
+			return false;
+		}
+
+		_component_buffer.push_back(match);
+	}
+
+	return true;
+}
+
+void EntityIndex::refresh_view(Entity& entity, QueryView& view)
+{
+	if (match_components(entity, view))
+	{
+		view.list.add(entity, _component_buffer);
+	}
+	else
+	{
+		view.list.remove(entity);
+	}
+}
+
+bool EntityIndex::derives_from(const ReflectedType* type, const ReflectedType* base)
+{
+	for (; type; type = resolve_base(type))
+	{
+		if (type == base)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const ReflectedType* EntityIndex::resolve_base(const ReflectedType* type)
+{
+	if (!type->base_info)
+	{
+		return nullptr;
+	}
+
+	return ReflectionDatabase::get().reflect_type(*type->base_info).get();
+}
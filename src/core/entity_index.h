@@ -0,0 +1,85 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <vector>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
+
+#include <memory/shared_ref.h>
+
+class Entity;
+class Component;
+struct ReflectedType;
+
+// Dense list of entities supporting constant time insertion and removal
+// Each row can additionally carry a fixed number of component pointers
+struct EntityIndexList
+{
+	size_t stride = 0;
+	std::vector<Entity*> entities;
+	std::vector<Component*> components;
+	std::unordered_map<const Entity*, size_t> rows;
+
+	// Adds the entity, or updates its components if it is already present
+	void add(Entity& entity, std::span<Component* const> row_components = {});
+	void remove(const Entity& entity);
+
+	[[nodiscard]] bool contains(const Entity& entity) const { return rows.contains(&entity); }
+	[[nodiscard]] bool empty() const noexcept { return entities.empty(); }
+};
+
+// Cached set of every entity with a component derived from each of the query types
+struct QueryView
+{
+	std::vector<const ReflectedType*> types;
+	EntityIndexList list;
+};
+
+// Incrementally maintained lookups of live entities by name, by type and by the components they own
+// Only modified by the entity subsystem while flushing, so can be read freely from ticks
+class EntityIndex
+{
+public:
+	EntityIndex() = default;
+	EntityIndex(const EntityIndex&) = delete;
+	EntityIndex(EntityIndex&&) = delete;
+
+	// Names and types are indexed when an entity is added, entity names are immutable so are never reindexed
+	void add_entity(Entity& entity);
+	void remove_entity(Entity& entity);
+
+	// Brings query views up to date with the current components of an entity
+	void refresh_components(Entity& entity);
+
+	void clear();
+
+	[[nodiscard]] const EntityIndexList* find_by_name(const std::string& name) const;
+
+	// Entities are indexed under their own type and every reflected type they derive from
+	[[nodiscard]] const EntityIndexList* find_by_type(const ReflectedType& type) const;
+
+	// Views are built on first use and maintained from then on, so the key must uniquely identify the type list
+	[[nodiscard]] const QueryView& find_or_create_view(
+		std::type_index key,
+		std::vector<const ReflectedType*>&& types,
+		const std::vector<peng::shared_ref<Entity>>& entities
+	);
+
+	[[nodiscard]] const QueryView* find_view(std::type_index key) const;
+
+private:
+	// Fills the component buffer with a matching component per query type, returns false if any are missing
+	[[nodiscard]] bool match_components(const Entity& entity, const QueryView& view);
+	void refresh_view(Entity& entity, QueryView& view);
+
+	[[nodiscard]] static bool derives_from(const ReflectedType* type, const ReflectedType* base);
+	[[nodiscard]] static const ReflectedType* resolve_base(const ReflectedType* type);
+
+	std::unordered_map<std::string, EntityIndexList> _name_lists;
+	std::unordered_map<const ReflectedType*, EntityIndexList> _type_lists;
+	std::unordered_map<std::type_index, std::unique_ptr<QueryView>> _views;
+
+	std::vector<Component*> _component_buffer;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <utility>
+
+#include "entity_index.h"
+
+// Typed view over an index list of entities, iterating doesn't allocate
+// Lists are only modified while the entity subsystem flushes, so views must not be held across flushes
+template <typename T>
+class EntityRange
+{
+public:
+	class Iterator
+	{
+	public:
+		using iterator = std::vector<Entity*>::const_iterator;
+
+		explicit Iterator(iterator it)
+			: _it(it)
+		{ }
+
+		[[nodiscard]] T& operator*() const { return static_cast<T&>(**_it); }
+		[[nodiscard]] T* operator->() const { return static_cast<T*>(*_it); }
+
+		Iterator& operator++() { ++_it; return *this; }
+		[[nodiscard]] bool operator==(const Iterator& other) const = default;
+
+	private:
+		iterator _it;
+	};
+
+	explicit EntityRange(const EntityIndexList* list)
+		: _entities(list ? &list->entities : &empty_entities())
+	{ }
+
+	[[nodiscard]] Iterator begin() const { return Iterator(_entities->begin()); }
+	[[nodiscard]] Iterator end() const { return Iterator(_entities->end()); }
+
+	[[nodiscard]] size_t size() const noexcept { return _entities->size(); }
+	[[nodiscard]] bool empty() const noexcept { return _entities->empty(); }
+
+private:
+	[[nodiscard]] static const std::vector<Entity*>& empty_entities()
+	{
+		static const std::vector<Entity*> entities;
+		return entities;
+	}
+
+	const std::vector<Entity*>* _entities;
+};
+
+// Iterates every entity owning a component of each of the query types, yielding the entity and its components
+// Usage: for (auto [entity, a, b] : EntitySubsystem::get().query<A, B>())
+template <typename...Ts>
+class EntityQuery
+{
+public:
+	using value_type = std::tuple<Entity&, Ts&...>;
+
+	class Iterator
+	{
+	public:
+		Iterator(const EntityIndexList& list, size_t row)
+			: _list(&list)
+			, _row(row)
+		{ }
+
+		[[nodiscard]] value_type operator*() const
+		{
+			return make_row(std::index_sequence_for<Ts...>());
+		}
+
+		Iterator& operator++() { ++_row; return *this; }
+		[[nodiscard]] bool operator==(const Iterator& other) const { return _row == other._row; }
+
+	private:
+		template <size_t...Is>
+		[[nodiscard]] value_type make_row(std::index_sequence<Is...>) const
+		{
+			Component* const* components = _list->components.data() + _row * sizeof...(Ts);
+			return value_type(*_list->entities[_row], static_cast<Ts&>(*components[Is])...);
+		}
+
+		const EntityIndexList* _list;
+		size_t _row;
+	};
+
+	explicit EntityQuery(const QueryView& view)
+		: _list(&view.list)
+	{ }
+
+	[[nodiscard]] Iterator begin() const { return Iterator(*_list, 0); }
+	[[nodiscard]] Iterator end() const { return Iterator(*_list, _list->entities.size()); }
+
+	[[nodiscard]] size_t size() const noexcept { return _list->entities.size(); }
+	[[nodiscard]] bool empty() const noexcept { return _list->entities.empty(); }
+
+private:
+	const EntityIndexList* _list;
+};
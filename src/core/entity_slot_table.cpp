@@ -0,0 +1,54 @@
+#include "entity_slot_table.h"
+
+#include <utils/check.h>
+
+EntitySlotTable::SlotId EntitySlotTable::allocate(Entity* entity)
+{
+	check(entity);
+
+	uint32_t index;
+	if (!_free_indices.empty())
+	{
+		index = _free_indices.back();
+		_free_indices.pop_back();
+	}
+	else
+	{
+		index = _num_slots++;
+
+		const uint32_t page_index = index / page_size;
+		check(page_index < max_pages);
+
+		if (!_page_storage[page_index])
+		{
+			_page_storage[page_index] = std::make_unique<Slot[]>(page_size);
+			_pages[page_index].store(_page_storage[page_index].get(), std::memory_order_release);
+		}
+	}
+
+	Slot& slot = _page_storage[index / page_size][index % page_size];
+	check(!slot.entity);
+	slot.entity = entity;
+
+	return SlotId{
+		.index = index,
+		.generation = slot.generation
+	};
+}
+
+void EntitySlotTable::release(uint32_t index)
+{
+	check(index < _num_slots);
+
+	Slot& slot = _page_storage[index / page_size][index % page_size];
+	check(slot.entity);
+
+	// Bumping the generation invalidates every outstanding handle to this slot
+	slot.entity = nullptr;
+	if (++slot.generation == 0)
+	{
+		slot.generation = 1;
+	}
+
+	_free_indices.push_back(index);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+class Entity;
+class EntitySubsystem;
+
+// Maps entity handles to live entities
+// Slots are stored in fixed size pages that are never moved or freed, so handles can be
+// resolved from any thread without locking while the entity subsystem creates new entities
+class EntitySlotTable
+{
+	friend EntitySubsystem;
+
+public:
+	static constexpr uint32_t page_size = 4096;
+	static constexpr uint32_t max_pages = 1024;
+	static constexpr uint32_t invalid_index = UINT32_MAX;
+
+	struct SlotId
+	{
+		uint32_t index = invalid_index;
+		uint32_t generation = 0;
+	};
+
+	// Returns the entity stored in the slot if the generation still matches, otherwise nullptr
+	[[nodiscard]] static Entity* resolve(uint32_t index, uint32_t generation) noexcept
+	{
+		const uint32_t page_index = index / page_size;
+		if (page_index >= max_pages)
+		{
+			return nullptr;
+		}
+
+		const Slot* page = _pages[page_index].load(std::memory_order_acquire);
+		if (!page)
+		{
+			return nullptr;
+		}
+
+		const Slot& slot = page[index % page_size];
+		return slot.generation == generation ? slot.entity : nullptr;
+	}
+
+	[[nodiscard]] static uint32_t num_live_slots() noexcept { return _num_slots - static_cast<uint32_t>(_free_indices.size()); }
+
+private:
+	struct Slot
+	{
+		Entity* entity = nullptr;
+
+		// Starts at 1 so that default constructed handles never resolve
+		uint32_t generation = 1;
+	};
+
+	// Should only be called by the entity subsystem on the main thread
+	static SlotId allocate(Entity* entity);
+	static void release(uint32_t index);
+
+	static inline std::array<std::atomic<Slot*>, max_pages> _pages = { };
+	static inline std::array<std::unique_ptr<Slot[]>, max_pages> _page_storage = { };
+	static inline std::vector<uint32_t> _free_indices;
+	static inline uint32_t _num_slots = 0;
+};
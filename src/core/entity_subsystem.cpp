@@ -1,16 +1,25 @@
 ﻿#include "entity_subsystem.h"
 
-#include <execution>
 #include <algorithm>
 #include <utils/vectools.h>
 #include <profiling/scoped_event.h>
+#include <profiling/counter.h>
+#include <memory/gc.h>
+#include <utils/timing.h>
+#include <threading/job_system.h>
 
 #include "entity.h"
 #include "component.h"
 #include "logger.h"
+#include "peng_engine.h"
+#include "reflection_database.h"
 
 EntitySubsystem::EntitySubsystem()
     : Subsystem()
+	, _num_tick_registry_updates(0)
+	, _ticking_group(false)
+	, _clearing_world(false)
+	, _storage_mode(EntityStorageMode::standard)
 {
 	constexpr int32_t start = static_cast<int32_t>(TickGroup::standard);
 	constexpr int32_t end = static_cast<int32_t>(TickGroup::none);
@@ -20,7 +29,21 @@ EntitySubsystem::EntitySubsystem()
 		const TickGroup group = static_cast<TickGroup>(tick_group);
 		_tick_groups.push_back(group);
 		_tick_group_names.push_back(strtools::cat(group));
+		_tick_counter_names.push_back(strtools::catf("EntitySubsystem - %s tickables", _tick_group_names.back().c_str()));
+		_low_priority_counter_names.push_back(strtools::catf("EntitySubsystem - %s low priority ticks", _tick_group_names.back().c_str()));
+		_tick_budgets.push_back(0);
 	}
+
+	_tick_scheduler.set_pre_concurrent_wave([this]
+	{
+		resolve_world_transforms();
+		_commands.begin_recording();
+	});
+
+	_tick_scheduler.set_post_concurrent_wave([this]
+	{
+		_commands.end_recording();
+	});
 }
 
 void EntitySubsystem::start()
@@ -33,14 +56,8 @@ void EntitySubsystem::shutdown()
 	SCOPED_EVENT("EntitySubsystem - shutdown");
 	Logger::log("Destroying all entities");
 
-	for (peng::shared_ref<Entity>& entity : _entities)
-	{
-		// TODO: add a destroy reason (explicit / shutdown)
-		entity->pre_destroy();
-	}
-
-	_pending_adds.clear();
-	_entities.clear();
+	// TODO: add a destroy reason (explicit / shutdown)
+	clear_world();
 }
 
 void EntitySubsystem::tick(float delta_time)
@@ -48,12 +65,29 @@ void EntitySubsystem::tick(float delta_time)
 	SCOPED_EVENT("EntitySubsystem - tick");
 
 	flush_pending_actions();
+	_behavior_scheduler.tick(delta_time);
 	tick_entities(delta_time);
+
+	SET_COUNTER("EntitySubsystem - tick registry updates", _num_tick_registry_updates);
+	_num_tick_registry_updates = 0;
 }
 
 void EntitySubsystem::register_entity(const peng::shared_ref<Entity>& entity)
 {
+	// Registration directly follows construction, even when the registration itself is recorded
+	entity->_creating = false;
+
+	if (_commands.recording())
+	{
+		_commands.record_register(entity);
+		return;
+	}
+
+	const EntitySlotTable::SlotId slot = EntitySlotTable::allocate(entity.get());
+	entity->_handle = EntityHandle<Entity>(slot.index, slot.generation);
+
 	entity->_constructed = true;
+	entity->_state = EntityState::pending_add;
 	_pending_adds.push_back(entity);
 }
 
@@ -65,46 +99,100 @@ void EntitySubsystem::destroy_entity(const peng::weak_ptr<Entity>& entity)
 		return;
 	}
 
-	// TODO: check if entity is already queued for destruction
+	if (_commands.recording())
+	{
+		_commands.record_destroy(entity.lock());
+		return;
+	}
+
+	// Destroying an entity that is already queued is a no-op, which also stops descendants being queued twice
+	if (entity->_state == EntityState::pending_kill || entity->_state == EntityState::invalid)
+	{
+		return;
+	}
+
+	entity->_state = EntityState::pending_kill;
 	_pending_kills.push_back(entity);
-	for (const peng::weak_ptr<Entity>& child : entity->children())
+
+	for (const EntityHandle<Entity>& child : entity->children())
 	{
-		destroy_entity(child);
+		destroy_entity(child.to_weak_ptr());
 	}
 }
 
-EntityState EntitySubsystem::get_entity_state(const peng::weak_ptr<Entity>& entity) const
+void EntitySubsystem::clear_world()
 {
-	if (vectools::contains(_pending_kills, entity))
-	{
-		return EntityState::pending_kill;
-	}
+	check(!_ticking_group);
+
+	SCOPED_EVENT("EntitySubsystem - clear world", strtools::catf_temp("%zu", _entities.size()));
+
+	_clearing_world = true;
 
-	if (const peng::shared_ptr<Entity> strong_entity = entity.lock())
 	{
-		const peng::shared_ref<Entity> entity_ref = strong_entity.to_shared_ref();
-		if (vectools::contains(_entities, entity_ref))
+		SCOPED_EVENT("EntitySubsystem - pre destroy all");
+		for (const peng::shared_ref<Entity>& entity : _entities)
 		{
-			return EntityState::valid;
+			if (entity->_created)
+			{
+				entity->pre_destroy();
+			}
 		}
-		if (vectools::contains(_pending_adds, entity_ref))
+	}
+
+	_clearing_world = false;
+
+	// Anything created during teardown is still pending an add and is discarded along with the rest
+	for (const std::vector<peng::shared_ref<Entity>>* buffer : { &_entities, &_pending_adds })
+	{
+		for (const peng::shared_ref<Entity>& entity : *buffer)
 		{
-			return EntityState::pending_add;
+			entity->_state = EntityState::invalid;
+			EntitySlotTable::release(entity->_handle.index());
 		}
 	}
 
+	_commands.clear();
+	_behavior_scheduler.clear();
+	_pending_refreshes.clear();
+	_pending_kills.clear();
+	_tick_registry.clear();
+	_archetype_storage.clear();
+	_transform_system.clear();
+	_physics_interpolator.clear();
+	_entity_index.clear();
+
+	{
+		SCOPED_EVENT("EntitySubsystem - release entities");
+		_pending_adds.clear();
+		_entities.clear();
+	}
+
+	// Storage modes are chosen per world, so the next world starts out with standard storage again
+	_storage_mode = EntityStorageMode::standard;
+
+	// Assets only referenced by the old world can go now rather than waiting out the GC grace period
+	memory::GC::get().collect();
+}
+
+EntityState EntitySubsystem::get_entity_state(const peng::weak_ptr<Entity>& entity) const
+{
+	if (const peng::shared_ptr<Entity> strong_entity = entity.lock())
+	{
+		return strong_entity->_state;
+	}
+
 	return EntityState::invalid;
 }
 
 peng::weak_ptr<Entity> EntitySubsystem::find_entity(const std::string& entity_name, bool include_inactive) const
 {
-	for (const peng::shared_ref<Entity>& entity : _entities)
+	if (const EntityIndexList* entities = _entity_index.find_by_name(entity_name))
 	{
-		if (include_inactive || entity->active_in_hierarchy())
+		for (Entity* entity : entities->entities)
 		{
-			if (entity->name() == entity_name)
+			if (include_inactive || entity->active_in_hierarchy())
 			{
-				return entity;
+				return entity->weak_this();
 			}
 		}
 	}
@@ -112,6 +200,11 @@ peng::weak_ptr<Entity> EntitySubsystem::find_entity(const std::string& entity_na
 	return {};
 }
 
+EntityRange<Entity> EntitySubsystem::find_entities_of_type(const ReflectedType& type) const
+{
+	return EntityRange<Entity>(_entity_index.find_by_type(type));
+}
+
 std::vector<peng::weak_ptr<Entity>> EntitySubsystem::all_entities()
 {
 	std::vector<peng::weak_ptr<Entity>> result;
@@ -125,6 +218,42 @@ std::vector<peng::weak_ptr<Entity>> EntitySubsystem::all_entities()
 	return result;
 }
 
+void EntitySubsystem::set_storage_mode(EntityStorageMode storage_mode)
+{
+	if (storage_mode == _storage_mode)
+	{
+		return;
+	}
+
+	SCOPED_EVENT("EntitySubsystem - set storage mode");
+
+	_storage_mode = storage_mode;
+	_archetype_storage.clear();
+
+	for (const peng::shared_ref<Entity>& entity : _entities)
+	{
+		if (_storage_mode == EntityStorageMode::archetype)
+		{
+			_archetype_storage.add_entity(*entity.get());
+		}
+
+		// Components are only held by the tick registry in standard mode
+		refresh_tickables(*entity.get());
+	}
+}
+
+void EntitySubsystem::set_tick_budget(TickGroup tick_group, float budget_ms)
+{
+	check(tick_group != TickGroup::none);
+	_tick_budgets[static_cast<int32_t>(tick_group)] = budget_ms;
+}
+
+float EntitySubsystem::tick_budget(TickGroup tick_group) const noexcept
+{
+	check(tick_group != TickGroup::none);
+	return _tick_budgets[static_cast<int32_t>(tick_group)];
+}
+
 void EntitySubsystem::dump_hierarchy() const
 {
 	if constexpr (!Logger::enabled())
@@ -132,12 +261,12 @@ void EntitySubsystem::dump_hierarchy() const
 		return;
 	}
 
-	std::vector<peng::weak_ptr<Entity>> root_entities;
+	std::vector<EntityHandle<Entity>> root_entities;
 	for (const peng::shared_ref<Entity>& entity : _entities)
 	{
 		if (!entity->parent().valid())
 		{
-			root_entities.emplace_back(entity);
+			root_entities.push_back(entity->handle());
 		}
 	}
 
@@ -152,132 +281,485 @@ void EntitySubsystem::dump_hierarchy() const
 	}
 }
 
-void EntitySubsystem::tick_entities(float delta_time)
+void EntitySubsystem::benchmark_teardown(int32_t num_entities)
 {
-	std::vector<peng::shared_ref<ITickable>> tickables;
+	SCOPED_EVENT("EntitySubsystem - benchmark teardown");
 
-	for (size_t i = 0; i < _tick_groups.size(); i++)
-	{
-		const TickGroup tick_group = _tick_groups[i];
+	constexpr int32_t children_per_root = 99;
+	const int32_t num_roots = std::max(num_entities / (children_per_root + 1), 1);
 
+	auto build_world = [&]
+	{
+		for (int32_t root_index = 0; root_index < num_roots; root_index++)
 		{
-			SCOPED_EVENT("EntitySubsystem - pre tick entity group", _tick_group_names[i].c_str());
-			_pre_tick_entity_group.invoke(tick_group);
+			const peng::weak_ptr<Entity> root = create_entity<Entity>("Benchmark Root", TickGroup::none);
+			for (int32_t child_index = 0; child_index < children_per_root; child_index++)
+			{
+				root->create_child<Entity>("Benchmark Child", TickGroup::none);
+			}
 		}
 
-		// Gather tickables for the current group
+		flush_pending_actions();
+	};
+
+	clear_world();
+
+	build_world();
+	const double destroy_ms = timing::measure_ms([this]
+	{
 		for (const peng::shared_ref<Entity>& entity : _entities)
 		{
-			if (entity->active_in_hierarchy())
+			if (!entity->has_parent())
 			{
-				if (entity->tick_group() == tick_group)
-				{
-					tickables.emplace_back(entity);
-				}
-
-				for (const peng::shared_ref<Component>& component : entity->components())
-				{
-					if (component->tick_group() == tick_group)
-					{
-						tickables.emplace_back(component);
-					}
-				}
+				entity->destroy();
 			}
 		}
 
-		{
-			SCOPED_EVENT("EntitySubsystem - ticking entity group", _tick_group_names[i].c_str());
+		flush_pending_actions();
+	});
 
-			for_each_tickable(
-				is_parallel_tick_group(tick_group),
-				tickables,
-				[&](const peng::shared_ref<ITickable>& tickable)
-				{
-					tickable->tick(delta_time);
-				});
+	build_world();
+	const double clear_ms = timing::measure_ms([this]
+	{
+		clear_world();
+	});
+
+	Logger::log(
+		"Teardown of %d entities: per-entity destroy %.2fms, clear_world %.2fms",
+		num_roots * (children_per_root + 1), destroy_ms, clear_ms
+	);
+}
+
+void EntitySubsystem::tick_entities(float delta_time)
+{
+	for (size_t i = 0; i < _tick_groups.size(); i++)
+	{
+		if (_tick_groups[i] == TickGroup::physics)
+		{
+			tick_physics_group(i);
+		}
+		else
+		{
+			tick_entity_group(i, delta_time);
 		}
+	}
+}
 
-		// Flush pending lifecycle updates (creation/destruction) after each group
-		tickables.clear();
-		flush_pending_actions();
+void EntitySubsystem::tick_entity_group(size_t group_index, float delta_time)
+{
+	const TickGroup tick_group = _tick_groups[group_index];
+
+	// Renderers read world matrices directly, so they're all brought up to date in one batched pass
+	if (tick_group == TickGroup::render_parallel)
+	{
+		resolve_world_transforms();
+	}
+
+	{
+		SCOPED_EVENT("EntitySubsystem - pre tick entity group", _tick_group_names[group_index].c_str());
+		_pre_tick_entity_group.invoke(tick_group);
+	}
+
+	{
+		SCOPED_EVENT("EntitySubsystem - ticking entity group", _tick_group_names[group_index].c_str());
+
+		// Components stored in archetypes are ticked by walking their chunks, unless they need the registry for scheduling
+		SET_COUNTER(_tick_counter_names[group_index].c_str(), _tick_registry.num_tickables(tick_group));
+
+		const TickClock& clock = _tick_registry.advance_clock(tick_group, delta_time);
 
+		_ticking_group = true;
+		_tick_scheduler.tick_group(
+			_tick_registry.buckets(tick_group),
+			is_parallel_tick_group(tick_group),
+			clock
+		);
+
+		if (_storage_mode == EntityStorageMode::archetype)
 		{
-			SCOPED_EVENT("EntitySubsystem - post tick entity group", _tick_group_names[i].c_str());
-			_post_tick_entity_group.invoke(tick_group);
+			tick_archetypes(tick_group, clock);
 		}
+
+		const size_t num_low_priority = _tick_scheduler.tick_slice(
+			_tick_registry.low_priority(tick_group),
+			clock,
+			_tick_budgets[group_index]
+		);
+
+		SET_COUNTER(_low_priority_counter_names[group_index].c_str(), num_low_priority);
+
+		_ticking_group = false;
+	}
+
+	// Flush pending lifecycle updates (creation/destruction) after each group
+	flush_pending_actions();
+
+	{
+		SCOPED_EVENT("EntitySubsystem - post tick entity group", _tick_group_names[group_index].c_str());
+		_post_tick_entity_group.invoke(tick_group);
 	}
 }
 
+void EntitySubsystem::tick_physics_group(size_t group_index)
+{
+	const PengEngine& engine = PengEngine::get();
+	const int32_t num_steps = engine.num_physics_steps();
+	const float fixed_delta_time = engine.fixed_timestep() / 1000.0f;
+
+	SCOPED_EVENT("EntitySubsystem - physics steps", strtools::catf_temp("%d", num_steps));
+
+	// Each step is a complete tick of the group, including flushing any lifecycle changes it made
+	_physics_interpolator.restore();
+	for (int32_t step = 0; step < num_steps; step++)
+	{
+		_physics_interpolator.begin_step();
+		tick_entity_group(group_index, fixed_delta_time);
+	}
+
+	_physics_interpolator.apply(engine.physics_alpha());
+}
+
 void EntitySubsystem::flush_pending_actions()
 {
+	flush_pending_commands();
+	flush_pending_refreshes();
 	flush_pending_kills();
 	flush_pending_adds();
 }
 
-template <typename F>
-void EntitySubsystem::for_each_tickable(bool parallel, const std::vector<peng::shared_ref<ITickable>>& tickables, F&& invocable)
+void EntitySubsystem::flush_pending_commands()
 {
-	if (parallel)
+	if (!_commands.gather(_command_buffer))
 	{
-		std::for_each(std::execution::par, tickables.begin(), tickables.end(), std::move(invocable));
+		return;
 	}
-	else
+
+	SCOPED_EVENT("EntitySubsystem - flush pending commands", strtools::catf_temp("%zu", _command_buffer.size()));
+
+	for (const EntityCommand& command : _command_buffer)
 	{
-		std::for_each(std::execution::seq, tickables.begin(), tickables.end(), std::move(invocable));
+		Entity& entity = *command.entity.get();
+
+		switch (command.type)
+		{
+			case EntityCommandType::register_entity:
+				register_entity(command.entity.to_shared_ref());
+				break;
+
+			case EntityCommandType::destroy_entity:
+				destroy_entity(command.entity);
+				break;
+
+			case EntityCommandType::set_parent:
+			{
+				// Either side may have been destroyed by an earlier command, a null parent clears the parent
+				const Entity* parent = command.parent.get();
+				if (entity._state != EntityState::invalid && (!parent || parent->_state != EntityState::invalid))
+				{
+					entity.set_parent(parent ? parent->_handle : EntityHandle<Entity>(), command.relationship);
+				}
+				break;
+			}
+
+			case EntityCommandType::attach_component:
+				if (entity._state != EntityState::invalid)
+				{
+					entity.attach_component(command.component.to_shared_ref(), command.component_id);
+				}
+				break;
+		}
 	}
+
+	// Releases the references held by the commands
+	_command_buffer.clear();
 }
 
 void EntitySubsystem::flush_pending_adds()
 {
 	const std::vector staged_adds(std::move(_pending_adds));
+	if (!staged_adds.empty())
+	{
+		_transform_system.mark_hierarchy_dirty();
+	}
 
 	for (const peng::shared_ref<Entity>& entity : staged_adds)
 	{
 		_entities.push_back(entity);
+		_entity_index.add_entity(*entity.get());
+		entity->_state = EntityState::valid;
 	}
 
 	for (const peng::shared_ref<Entity>& entity : staged_adds)
 	{
+		entity->_creating = true;
 		entity->post_create();
+		entity->_creating = false;
+	}
+
+	for (const peng::shared_ref<Entity>& entity : staged_adds)
+	{
+		refresh_tickables(*entity.get());
+		_entity_index.refresh_components(*entity.get());
+	}
+
+	if (_storage_mode == EntityStorageMode::archetype)
+	{
+		// Placed after post_create so that components added during creation don't cause an immediate move
+		// Entities may already have been placed if the storage mode was changed during post_create
+		for (const peng::shared_ref<Entity>& entity : staged_adds)
+		{
+			if (!entity->_archetype)
+			{
+				_archetype_storage.add_entity(*entity.get());
+			}
+		}
 	}
 }
 
 void EntitySubsystem::flush_pending_kills()
 {
-	auto kill_in_buffer = [&](std::vector<peng::shared_ref<Entity>>& entities, bool exists_yet)
+	if (_pending_kills.empty())
 	{
-		for (int32_t entity_index = static_cast<int32_t>(entities.size() - 1); entity_index >= 0; entity_index--)
+		return;
+	}
+
+	SCOPED_EVENT("EntitySubsystem - flush pending kills");
+
+	// Slots are only released once every kill has been processed so that
+	// pre_destroy can still resolve handles to other entities dying this frame
+	std::vector<uint32_t> released_slots;
+	std::vector<peng::weak_ptr<Entity>> killed_entities;
+
+	// Destroying an entity can queue further kills, these are handled within the same flush
+	while (!_pending_kills.empty())
+	{
+		const std::vector staged_kills(std::move(_pending_kills));
+		_pending_kills.clear();
+
+		// Descendants are queued after their ancestors so processing in reverse destroys children first
+		for (auto it = staged_kills.rbegin(); it != staged_kills.rend(); ++it)
 		{
-			peng::shared_ref<Entity>& entity = entities[entity_index];
-			peng::weak_ptr<Entity> weak_entity = entity;
+			const peng::shared_ptr<Entity> locked_entity = it->lock();
+			check(locked_entity);
 
-			if (vectools::contains(_pending_kills, weak_entity))
+			Entity& entity = *locked_entity.get();
+
+			// Entities killed while still pending an add were never created so don't receive pre_destroy
+			if (entity._created)
 			{
-				if (exists_yet)
-				{
-					entity->pre_destroy();
-				}
+				entity.pre_destroy();
+			}
+
+			unregister_tickables(entity);
+			_archetype_storage.remove_entity(entity);
+			_entity_index.remove_entity(entity);
+
+			entity._state = EntityState::invalid;
+			released_slots.push_back(entity._handle.index());
+			killed_entities.push_back(*it);
+		}
+	}
+
+	// Killed entities are compacted out in a single pass rather than erased one at a time
+	auto is_killed = [](const peng::shared_ref<Entity>& entity)
+	{
+		return entity->_state == EntityState::invalid;
+	};
+
+	vectools::remove_all<peng::shared_ref<Entity>>(_entities, is_killed);
+	vectools::remove_all<peng::shared_ref<Entity>>(_pending_adds, is_killed);
+
+	for (const uint32_t slot : released_slots)
+	{
+		EntitySlotTable::release(slot);
+	}
+
+	_transform_system.mark_hierarchy_dirty();
+
+	for (const peng::weak_ptr<Entity>& weak_entity : killed_entities)
+	{
+		if (weak_entity.valid())
+		{
+			Logger::warning(
+				"Entity '%s' still exists after kill, potential leak",
+				weak_entity->name().c_str()
+			);
+		}
+	}
+}
+
+void EntitySubsystem::flush_pending_refreshes()
+{
+	if (_pending_refreshes.empty())
+	{
+		return;
+	}
+
+	SCOPED_EVENT("EntitySubsystem - flush pending refreshes");
+
+	for (const EntityHandle<Entity>& handle : _pending_refreshes)
+	{
+		// Entities killed since being queued will no longer resolve
+		Entity* entity = handle.get();
+		if (!entity)
+		{
+			continue;
+		}
+
+		const EntityRefresh refresh = entity->_pending_refresh;
+		entity->_pending_refresh = EntityRefresh::none;
+
+		if ((refresh & EntityRefresh::archetype) == EntityRefresh::archetype && entity->_archetype)
+		{
+			_archetype_storage.refresh_entity(*entity);
+		}
+
+		if ((refresh & EntityRefresh::tickables) == EntityRefresh::tickables)
+		{
+			refresh_tickables(*entity);
+		}
+
+		if ((refresh & EntityRefresh::queries) == EntityRefresh::queries)
+		{
+			_entity_index.refresh_components(*entity);
+		}
+	}
+
+	_pending_refreshes.clear();
+}
+
+void EntitySubsystem::tick_archetypes(TickGroup tick_group, const TickClock& clock)
+{
+	_chunk_buffer.clear();
+	_archetype_storage.gather_chunks(_chunk_buffer);
 
-				entities.erase(entities.begin() + entity_index);
+	auto tick_chunk = [=, this, &clock](Archetype::Chunk* const& chunk)
+	{
+		// Archetypes tick after the tick registry, so their commands are ordered after every registered tickable
+		const uint64_t chunk_index = &chunk - _chunk_buffer.data();
+		uint64_t issue_order = (chunk_index + 1) << 32;
 
-				if (weak_entity.valid())
+		// Row by row so that all of an entity's components tick together, as they do from the tick registry
+		for (int32_t row = 0; row < chunk->size; row++)
+		{
+			if (!chunk->entities[row]->active_in_hierarchy())
+			{
+				continue;
+			}
+
+			for (const Archetype::Column& column : chunk->columns)
+			{
+				// Components that need scheduling are ticked by the tick registry instead
+				Component& component = *column.components[row];
+				if (column.tick_groups[row] == tick_group && !component.tick_registered())
 				{
-					Logger::warning(
-						"Entity '%s' still exists after kill, potential leak",
-						weak_entity->name().c_str()
-					);
+					// Priority can't be honoured here, it has to be set before the entity is created
+					check(component.tick_priority() == TickPriority::normal);
+
+					EntityCommandQueue::set_issue_order(issue_order++);
+					TickScheduler::tick_tickable(component, clock);
 				}
 			}
 		}
 	};
 
-	kill_in_buffer(_entities, true);
-	kill_in_buffer(_pending_adds, false);
+	if (is_parallel_tick_group(tick_group))
+	{
+		resolve_world_transforms();
 
-	_pending_kills.clear();
+		_commands.begin_recording();
+		threading::JobSystem::get().parallel_for(_chunk_buffer, 1, tick_chunk);
+		_commands.end_recording();
+	}
+	else
+	{
+		std::for_each(_chunk_buffer.begin(), _chunk_buffer.end(), tick_chunk);
+	}
+}
+
+void EntitySubsystem::resolve_world_transforms()
+{
+	_transform_system.update(_entities);
+}
+
+void EntitySubsystem::mark_hierarchy_dirty() noexcept
+{
+	_transform_system.mark_hierarchy_dirty();
+}
+
+void EntitySubsystem::mark_transform_dirty(Entity& entity)
+{
+	_transform_system.mark_transform_dirty(entity.handle());
+}
+
+void EntitySubsystem::queue_refresh(Entity& entity, EntityRefresh refresh)
+{
+	// Refreshes are unsynchronised, the structural changes that queue them are recorded instead while ticking concurrently
+	check(!_commands.recording());
+
+	if (entity._pending_refresh == EntityRefresh::none)
+	{
+		_pending_refreshes.push_back(entity.handle());
+	}
+
+	entity._pending_refresh = entity._pending_refresh | refresh;
+}
+
+void EntitySubsystem::refresh_tickables(Entity& entity)
+{
+	if (!entity._created)
+	{
+		return;
+	}
+
+	const bool ticking = entity.active_in_hierarchy();
+	refresh_tickable(entity, ticking);
+
+	// Archetype chunks tick every component on every tick, so components that need scheduling stay in the registry
+	for (const peng::shared_ref<Component>& component : entity.components())
+	{
+		const bool registry_ticked = _storage_mode == EntityStorageMode::standard || component->tick_scheduled();
+		refresh_tickable(*component.get(), ticking && registry_ticked);
+	}
+}
+
+void EntitySubsystem::refresh_tickable(ITickable& tickable, bool ticking)
+{
+	if (!ticking || tickable.tick_group() == TickGroup::none)
+	{
+		if (tickable.tick_registered())
+		{
+			_tick_registry.remove(tickable);
+			_num_tick_registry_updates++;
+		}
+
+		return;
+	}
+
+	if (tickable.tick_registered())
+	{
+		return;
+	}
+
+	// Types that don't override tick are never registered, types without reflection info are assumed to tick
+	const peng::shared_ptr<const ReflectedType> reflected_type = ReflectionDatabase::get().reflect_type(typeid(tickable));
+	if (!reflected_type || reflected_type->has_tick)
+	{
+		_tick_registry.add(tickable, reflected_type.get());
+		_num_tick_registry_updates++;
+	}
+}
+
+void EntitySubsystem::unregister_tickables(Entity& entity)
+{
+	refresh_tickable(entity, false);
+	for (const peng::shared_ref<Component>& component : entity.components())
+	{
+		refresh_tickable(*component.get(), false);
+	}
 }
 
-std::string EntitySubsystem::build_entity_hierarchy(const std::vector<peng::weak_ptr<Entity>>& root_entities) const
+std::string EntitySubsystem::build_entity_hierarchy(const std::vector<EntityHandle<Entity>>& root_entities) const
 {
 	std::string result;
 	std::vector<bool> draw_vertical;
@@ -287,7 +769,7 @@ std::string EntitySubsystem::build_entity_hierarchy(const std::vector<peng::weak
 }
 
 void EntitySubsystem::build_entity_hierarchy(
-	const std::vector<peng::weak_ptr<Entity>>& root_entities,
+	const std::vector<EntityHandle<Entity>>& root_entities,
 	int32_t depth,
 	std::vector<bool>& draw_vertical,
 	std::string& result
@@ -301,7 +783,7 @@ void EntitySubsystem::build_entity_hierarchy(
 
 	for (size_t root_index = 0; root_index < root_entities.size(); root_index++)
 	{
-		const peng::weak_ptr<Entity>& root = root_entities[root_index];
+		const EntityHandle<Entity>& root = root_entities[root_index];
 
 		for (int32_t d = 0; d < depth; d++)
 		{
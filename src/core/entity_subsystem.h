@@ -5,10 +5,23 @@
 
 #include <memory/shared_ref.h>
 #include <memory/weak_ptr.h>
+#include <memory/pool_allocator.h>
 #include <utils/event.h>
+#include <utils/enum_flags.h>
 
 #include "subsystem.h"
 #include "tickable.h"
+#include "tick_registry.h"
+#include "tick_scheduler.h"
+#include "transform_system.h"
+#include "physics_interpolator.h"
+#include "entity_index.h"
+#include "entity_command_queue.h"
+#include "behavior_scheduler.h"
+#include "entity_query.h"
+#include "reflection_database.h"
+#include "entity_handle.h"
+#include "archetype_storage.h"
 
 enum class EntityState
 {
@@ -18,12 +31,38 @@ enum class EntityState
 	pending_kill
 };
 
+enum class EntityStorageMode
+{
+	// Components are only stored on their owning entity
+	standard,
+
+	// Components are additionally grouped into archetype chunks, which are ticked in place of the tick registry
+	// Entities tick chunk by chunk in row order, and each entity's components tick in signature order
+	// (sorted by type) rather than the order they were added in
+	archetype
+};
+
+// Bookkeeping that must be brought up to date for an entity at the next flush
+enum class EntityRefresh
+{
+	archetype = 1 << 0,
+	tickables = 1 << 1,
+	queries = 1 << 2,
+
+	none = 0
+};
+
+ENUM_FLAGS(EntityRefresh)
+
 class Entity;
+class Component;
 
 class EntitySubsystem final : public Subsystem
 {
 	DECLARE_SUBSYSTEM(EntitySubsystem)
 
+	friend Entity;
+
 	DEFINE_EVENT(pre_tick_entity_group, TickGroup)
 	DEFINE_EVENT(post_tick_entity_group, TickGroup)
 
@@ -45,33 +84,92 @@ public:
 
 	// Register an entity that was constructed externally with the entity manager
 	// Once registered, the entity manager is responsible for the lifetime of the entity
+	// Entities registered while ticking concurrently only receive a handle at the next flush
 	void register_entity(const peng::shared_ref<Entity>& entity);
 
 	// Destroys an entity owned by the entity manager
 	void destroy_entity(const peng::weak_ptr<Entity>& entity);
 
+	// True while entities are ticking concurrently, structural changes made during this time
+	// (creating, destroying, parenting and adding components) are recorded and applied at the next flush
+	[[nodiscard]] bool recording_commands() const noexcept { return _commands.recording(); }
+
+	// Immediately destroys every entity, including those pending an add, and frees unreferenced GC objects
+	// Every entity receives pre_destroy in a single pass without any hierarchy or activity bookkeeping
+	// Must not be called while an entity group is ticking
+	void clear_world();
+	[[nodiscard]] bool clearing_world() const noexcept { return _clearing_world; }
+
 	[[nodiscard]] EntityState get_entity_state(const peng::weak_ptr<Entity>& entity) const;
 	[[nodiscard]] peng::weak_ptr<Entity> find_entity(const std::string& entity_name, bool include_inactive) const;
-	// TODO: add templated and non templated functions for finding entity/entities via type
+
+	// Returns every live entity of the given type, including entities of derived types
+	template <std::derived_from<Entity> T>
+	[[nodiscard]] EntityRange<T> find_entities_of_type() const;
+	[[nodiscard]] EntityRange<Entity> find_entities_of_type(const ReflectedType& type) const;
+
+	// Returns every live entity owning a component derived from each of the given types
+	// The first query for a set of types builds a cached view, so must not be made from a parallel tick group
+	template <std::derived_from<Component>...Ts>
+	requires (sizeof...(Ts) > 0)
+	[[nodiscard]] EntityQuery<Ts...> query();
 
 	[[nodiscard]] std::vector<peng::weak_ptr<Entity>> all_entities();
 
+	// Switches how components are stored and ticked, existing entities are migrated immediately
+	// Only lasts for the current world, clearing the world switches back to standard storage
+	// Must not be called from within a component tick
+	void set_storage_mode(EntityStorageMode storage_mode);
+	[[nodiscard]] EntityStorageMode storage_mode() const noexcept { return _storage_mode; }
+	[[nodiscard]] const ArchetypeStorage& archetype_storage() const noexcept { return _archetype_storage; }
+
+	// Limits how long the low priority tickables of a group may take each time the group ticks
+	// Tickables that didn't fit are resumed the next time, a budget of 0 ticks every low priority tickable
+	void set_tick_budget(TickGroup tick_group, float budget_ms);
+	[[nodiscard]] float tick_budget(TickGroup tick_group) const noexcept;
+
+	[[nodiscard]] BehaviorScheduler& behavior_scheduler() noexcept { return _behavior_scheduler; }
+
 	void dump_hierarchy() const;
+
+	// Destroys the current world, then times tearing down a generated world of the given
+	// size through per-entity destroys against tearing it down with clear_world
+	void benchmark_teardown(int32_t num_entities);
 	// ----------------------------------
 
 private:
 	void tick_entities(float delta_time);
 	void flush_pending_actions();
+	void flush_pending_commands();
 	void flush_pending_adds();
 	void flush_pending_kills();
+	void flush_pending_refreshes();
 
-	[[nodiscard]] std::string build_entity_hierarchy(const std::vector<peng::weak_ptr<Entity>>& root_entities) const;
+	void tick_entity_group(size_t group_index, float delta_time);
+	void tick_physics_group(size_t group_index);
+	void tick_archetypes(TickGroup tick_group, const TickClock& clock);
 
-	template <typename F>
-	void for_each_tickable(bool parallel, const std::vector<peng::shared_ref<ITickable>>& tickables, F&& invocable);
+	// Builds any invalidated world matrices so that concurrent ticks only ever read them
+	void resolve_world_transforms();
+
+	// Called by entities when they are reparented, or when their cached world transform is invalidated
+	void mark_hierarchy_dirty() noexcept;
+	void mark_transform_dirty(Entity& entity);
+
+	// Archetypes and tick lists can't be modified while they are being ticked
+	// so any changes are deferred until the next flush
+	// Not thread safe, so must not be called while commands are being recorded
+	void queue_refresh(Entity& entity, EntityRefresh refresh);
+
+	// Brings the tick registry up to date with the activity of an entity and its components
+	void refresh_tickables(Entity& entity);
+	void unregister_tickables(Entity& entity);
+	void refresh_tickable(ITickable& tickable, bool ticking);
+
+	[[nodiscard]] std::string build_entity_hierarchy(const std::vector<EntityHandle<Entity>>& root_entities) const;
 
 	void build_entity_hierarchy(
-		const std::vector<peng::weak_ptr<Entity>>& root_entities,
+		const std::vector<EntityHandle<Entity>>& root_entities,
 		int32_t depth,
 		std::vector<bool>& draw_vertical,
 		std::string& result
@@ -79,17 +177,66 @@ private:
 
 	std::vector<TickGroup> _tick_groups;
 	std::vector<std::string> _tick_group_names;
+	std::vector<std::string> _tick_counter_names;
+	std::vector<std::string> _low_priority_counter_names;
+	std::vector<float> _tick_budgets;
 	std::vector<peng::shared_ref<Entity>> _entities;
 	std::vector<peng::shared_ref<Entity>> _pending_adds;
 	std::vector<peng::weak_ptr<Entity>> _pending_kills;
+
+	std::vector<EntityHandle<Entity>> _pending_refreshes;
+
+	EntityCommandQueue _commands;
+	std::vector<EntityCommand> _command_buffer;
+
+	TickRegistry _tick_registry;
+	TickScheduler _tick_scheduler;
+	TransformSystem _transform_system;
+	PhysicsInterpolator _physics_interpolator;
+	BehaviorScheduler _behavior_scheduler;
+	EntityIndex _entity_index;
+	int32_t _num_tick_registry_updates;
+
+	bool _ticking_group;
+	bool _clearing_world;
+
+	EntityStorageMode _storage_mode;
+	ArchetypeStorage _archetype_storage;
+	std::vector<Archetype::Chunk*> _chunk_buffer;
 };
 
 template <std::derived_from<Entity> T, typename...Args>
 requires std::constructible_from<T, Args...>
 peng::weak_ptr<T> EntitySubsystem::create_entity(Args&&...args)
 {
-	peng::shared_ref<T> entity = peng::make_shared<T>(std::forward<Args>(args)...);
+	// Entities of the same type are pooled together for locality when ticking
+	const memory::PoolAllocator<T> allocator(memory::PoolRegistry::pool<T>());
+	peng::shared_ref<T> entity = peng::allocate_shared<T>(allocator, std::forward<Args>(args)...);
 	register_entity(entity);
 
 	return entity;
 }
+
+template <std::derived_from<Entity> T>
+EntityRange<T> EntitySubsystem::find_entities_of_type() const
+{
+	const peng::shared_ptr<const ReflectedType> type = ReflectionDatabase::get().reflect_type<T>();
+	return EntityRange<T>(type ? _entity_index.find_by_type(*type.get()) : nullptr);
+}
+
+template <std::derived_from<Component>...Ts>
+requires (sizeof...(Ts) > 0)
+EntityQuery<Ts...> EntitySubsystem::query()
+{
+	const std::type_index key = typeid(EntityQuery<Ts...>);
+	if (const QueryView* view = _entity_index.find_view(key))
+	{
+		return EntityQuery<Ts...>(*view);
+	}
+
+	std::vector<const ReflectedType*> types = {
+		ReflectionDatabase::get().reflect_type_checked<Ts>().get()...
+	};
+
+	return EntityQuery<Ts...>(_entity_index.find_or_create_view(key, std::move(types), _entities));
+}
@@ -21,27 +21,32 @@ Logger::~Logger()
 }
 
 #ifdef NO_LOGGING
-void Logger::log(LogSeverity, const std::string&) {}
+void Logger::log(LogSeverity, std::string) {}
 #else
-void Logger::log(LogSeverity severity, const std::string& message)
+void Logger::log(LogSeverity severity, std::string message)
 {
 	Log log = {
 		.severity = severity,
-		.message = message,
-		.timestamp = time_now_info(),
 		.frame_number = PengEngine::exists()
 			? PengEngine::get().frame_number()
-			: 0
+			: 0,
+		.message = std::move(message),
+		.timestamp = time(nullptr)
 	};
 
-    _worker_thread.schedule_job(threading::Job([this, log = std::move(log)]
+	auto log_job = [this, log = std::move(log)]
 	{
 		log_internal(log);
-	}));
+	};
+
+	static_assert(threading::Job::stores_inline<decltype(log_job)>, "Logging should not allocate a job");
+	_worker_thread.schedule_job(threading::Job(std::move(log_job)));
 }
 
 void Logger::log_internal(const Log& log)
 {
+	const tm timestamp = local_time(log.timestamp);
+
 	// Open the log file if we haven't already
 	// TODO: we might want to limit the number of old log files to keep
 	if (!_log_file.is_open())
@@ -49,8 +54,8 @@ void Logger::log_internal(const Log& log)
 		// Logger path = logs/YYYY-MM-DD/HH-MM-SS.log
 		const std::string log_path = strtools::catf(
 			"logs/%04d-%02d-%02d/%02d-%02d-%02d.log",
-			1900 + log.timestamp.tm_year, 1 + log.timestamp.tm_mon, log.timestamp.tm_mday,
-			log.timestamp.tm_hour, log.timestamp.tm_min, log.timestamp.tm_sec
+			1900 + timestamp.tm_year, 1 + timestamp.tm_mon, timestamp.tm_mday,
+			timestamp.tm_hour, timestamp.tm_min, timestamp.tm_sec
 		);
 
 		io::create_directories_for_file(log_path);
@@ -97,7 +102,7 @@ void Logger::log_internal(const Log& log)
 	// [HH:MM:SS][F]
 	const std::string time_code = strtools::catf(
 		"[%02d:%02d:%02d][%d] ",
-		log.timestamp.tm_hour, log.timestamp.tm_min, log.timestamp.tm_sec,
+		timestamp.tm_hour, timestamp.tm_min, timestamp.tm_sec,
 		log.frame_number
 	);
 
@@ -119,11 +124,10 @@ void Logger::log_internal(const Log& log)
 	std::cout << "\n";
 }
 
-tm Logger::time_now_info() const
+tm Logger::local_time(time_t time)
 {
-	const time_t time_now = time(nullptr);
 	tm time_info = {};
-	localtime_s(&time_info, &time_now);
+	localtime_s(&time_info, &time);
 
 	return time_info;
 }
@@ -24,7 +24,7 @@ class Logger : public utils::Singleton<Logger>
 	friend Singleton;
 
 public:
-	void log(LogSeverity severity, const std::string& message);
+	void log(LogSeverity severity, std::string message);
 
 	template <typename...Args>
 	void logf(LogSeverity severity, const char* format, Args&&...args);
@@ -49,12 +49,14 @@ public:
 	consteval static bool enabled();
 
 private:
+	// Kept small enough for the job capturing it to be stored inline, so the timestamp
+	// is only broken down into local time once it reaches the worker thread
 	struct Log
 	{
 		LogSeverity severity;
-		std::string message;
-		tm timestamp;
 		int32_t frame_number;
+		std::string message;
+		time_t timestamp;
 	};
 
 	Logger();
@@ -62,7 +64,7 @@ private:
 
 #ifndef NO_LOGGING
     void log_internal(const Log& log);
-	[[nodiscard]] tm time_now_info() const;
+	[[nodiscard]] static tm local_time(time_t time);
 
 	std::ofstream _log_file;
 	threading::WorkerThread _worker_thread;
@@ -1,17 +1,24 @@
 #include "peng_engine.h"
 
+#include <cmath>
 #include <GL/glew.h>
 
 #include <utils/timing.h>
 #include <memory/gc.h>
+#include <memory/frame_arena.h>
+#include <rendering/gpu_deletion_queue.h>
 #include <rendering/render_queue.h>
 #include <rendering/window_subsystem.h>
+#include <threading/job_system.h>
 #include <audio/audio_subsystem.h>
 #include <input/input_subsystem.h>
 #include <profiling/scoped_event.h>
+#include <profiling/counter.h>
+#include <profiling/alloc_tracker.h>
 
 #include "logger.h"
 #include "entity_subsystem.h"
+#include "timer_subsystem.h"
 
 PengEngine::PengEngine()
 	: Singleton()
@@ -22,10 +29,18 @@ PengEngine::PengEngine()
     , _time_scale(1)
 	, _frame_number(0)
 	, _last_frametime(_target_frametime)
+	, _fixed_timestep(1000 / 60.0f)
+	, _max_physics_steps(4)
+	, _physics_accumulator(0)
+	, _num_physics_steps(0)
 {
+	// The job system treats the thread that creates it as the main thread
+	threading::JobSystem::get();
+
 	Subsystem::load<rendering::WindowSubsystem>();
 	Subsystem::load<audio::AudioSubsystem>();
 	Subsystem::load<input::InputSubsystem>();
+	Subsystem::load<TimerSubsystem>();
 	Subsystem::load<EntitySubsystem>();
 }
 
@@ -71,6 +86,18 @@ void PengEngine::set_time_scale(float time_scale) noexcept
 	_time_scale = time_scale;
 }
 
+void PengEngine::set_fixed_timestep(float timestep_ms) noexcept
+{
+	check(timestep_ms > 0);
+	_fixed_timestep = timestep_ms;
+}
+
+void PengEngine::set_max_physics_steps(int32_t max_steps) noexcept
+{
+	check(max_steps > 0);
+	_max_physics_steps = max_steps;
+}
+
 bool PengEngine::shutting_down() const
 {
 	if (_shutting_down)
@@ -101,6 +128,21 @@ float PengEngine::last_frametime() const noexcept
 	return _last_frametime;
 }
 
+float PengEngine::fixed_timestep() const noexcept
+{
+	return _fixed_timestep;
+}
+
+int32_t PengEngine::num_physics_steps() const noexcept
+{
+	return _num_physics_steps;
+}
+
+float PengEngine::physics_alpha() const noexcept
+{
+	return _physics_accumulator / _fixed_timestep;
+}
+
 void PengEngine::start()
 {
 	SCOPED_EVENT("PengEngine - start");
@@ -119,6 +161,7 @@ void PengEngine::shutdown()
 	SCOPED_EVENT("PengEngine - shutdown");
 
 	Subsystem::shutdown_all();
+	threading::JobSystem::get().shutdown();
 
 	_shutting_down = false;
 	_executing = false;
@@ -135,6 +178,7 @@ void PengEngine::tick()
 
 	memory::GC::get().tick();
 	rendering::WindowSubsystem::get().finalize_frame(_target_frametime);
+	track_allocations();
 
 	_frame_number++;
 }
@@ -149,14 +193,67 @@ void PengEngine::tick_main()
 		: _last_frametime;
 
 	const float delta_time = frametime_capped / 1000.0f;
-	
+	advance_physics_clock(frametime_capped);
+
 	_on_frame_start();
 
 	Subsystem::tick_all(delta_time);
 
 	_on_frame_end();
+
+	// Everything allocated from the frame arenas since the previous frame ended is dead by now
+	memory::FrameArena::reset_all();
 }
 
+void PengEngine::advance_physics_clock(float frametime_ms)
+{
+	_physics_accumulator += frametime_ms;
+	_num_physics_steps = static_cast<int32_t>(_physics_accumulator / _fixed_timestep);
+
+	if (_num_physics_steps > _max_physics_steps)
+	{
+		// Catching up fully would make the next frame even slower, so the simulation falls behind real time instead
+		_num_physics_steps = _max_physics_steps;
+		_physics_accumulator = std::fmod(_physics_accumulator, _fixed_timestep);
+	}
+	else
+	{
+		_physics_accumulator -= _num_physics_steps * _fixed_timestep;
+	}
+
+	SET_COUNTER("PengEngine - physics steps", _num_physics_steps);
+}
+
+#ifndef NO_PROFILING
+void PengEngine::track_allocations()
+{
+	profiling::AllocTracker& tracker = profiling::AllocTracker::get();
+	if (!tracker.enabled())
+	{
+		return;
+	}
+
+	const profiling::FrameAllocations& allocations = tracker.end_frame();
+	if (!allocations.over_budget)
+	{
+		return;
+	}
+
+	Logger::error("Frame %d made %llu allocations (%llu bytes), exceeding the allocation budget", _frame_number, allocations.count, allocations.bytes);
+
+	constexpr size_t max_scopes_reported = 10;
+	for (size_t i = 0; i < std::min(allocations.scopes.size(), max_scopes_reported); i++)
+	{
+		const profiling::ScopeAllocations& scope = allocations.scopes[i];
+		Logger::error("    %s: %llu allocations (%llu bytes)", scope.scope, scope.count, scope.bytes);
+	}
+
+	request_shutdown();
+}
+#else
+void PengEngine::track_allocations() { }
+#endif
+
 void PengEngine::tick_render()
 {
 	SCOPED_EVENT("PengEngine - tick render");
@@ -179,4 +276,5 @@ void PengEngine::tick_render()
 #endif
 
 	rendering::RenderQueue::get().execute();
+	rendering::GpuDeletionQueue::get().flush();
 }
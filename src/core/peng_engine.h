@@ -21,11 +21,22 @@ public:
 	void set_max_delta_time(float frametime_ms) noexcept;
 	void set_time_scale(float time_scale) noexcept;
 
+	// The physics tick group runs at a fixed rate independent of the frame rate
+	// Frames that fall behind run several physics steps, up to the maximum, with any further time being dropped
+	void set_fixed_timestep(float timestep_ms) noexcept;
+	void set_max_physics_steps(int32_t max_steps) noexcept;
+
 	[[nodiscard]] bool shutting_down() const;
 	[[nodiscard]] float time_scale() const noexcept;
 	[[nodiscard]] int32_t frame_number() const noexcept;
 	[[nodiscard]] float last_frametime() const noexcept;
 
+	[[nodiscard]] float fixed_timestep() const noexcept;
+	[[nodiscard]] int32_t num_physics_steps() const noexcept;
+
+	// How far the frame is between the last two physics steps, in the range [0, 1)
+	[[nodiscard]] float physics_alpha() const noexcept;
+
 private:
 	PengEngine();
 
@@ -36,6 +47,12 @@ private:
 	void tick_main();
 	void tick_render();
 
+	// Adds the frame time to the physics accumulator and works out how many physics steps to run
+	void advance_physics_clock(float frametime_ms);
+
+	// Gathers the frame's allocations while allocation tracking is enabled, failing the run if they exceed the budget
+	void track_allocations();
+
 	bool _executing;
 	bool _shutting_down;
 	float _target_frametime;
@@ -44,4 +61,9 @@ private:
 
 	int32_t _frame_number;
 	float _last_frametime;
+
+	float _fixed_timestep;
+	int32_t _max_physics_steps;
+	float _physics_accumulator;
+	int32_t _num_physics_steps;
 };
\ No newline at end of file
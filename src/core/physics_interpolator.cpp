@@ -0,0 +1,79 @@
+#include "physics_interpolator.h"
+
+#include <algorithm>
+
+#include <utils/vectools.h>
+#include <profiling/scoped_event.h>
+
+#include "entity.h"
+
+void PhysicsInterpolator::add(Entity& entity)
+{
+	_entries.push_back(Entry{
+		.entity = entity.handle(),
+		.previous = entity.local_transform()
+	});
+}
+
+void PhysicsInterpolator::remove(Entity& entity)
+{
+	const auto it = std::ranges::find(_entries, entity.handle(), &Entry::entity);
+	if (it != _entries.end())
+	{
+		entity.clear_interpolated_transform();
+		_entries.erase(it);
+	}
+}
+
+void PhysicsInterpolator::restore()
+{
+	SCOPED_EVENT("PhysicsInterpolator - restore");
+
+	vectools::remove_all<Entry>(_entries, [](const Entry& entry)
+	{
+		return !entry.entity.valid();
+	});
+
+	for (Entry& entry : _entries)
+	{
+		Entity& entity = *entry.entity;
+
+		// Writing the local transform stops the blend, so the entity was moved outside of the physics steps
+		if (!entity._render_interpolated)
+		{
+			entry.previous = std::as_const(entity).local_transform();
+		}
+
+		entity.clear_interpolated_transform();
+	}
+}
+
+void PhysicsInterpolator::begin_step()
+{
+	for (Entry& entry : _entries)
+	{
+		if (const Entity* entity = entry.entity.get())
+		{
+			entry.previous = entity->local_transform();
+		}
+	}
+}
+
+void PhysicsInterpolator::apply(float alpha)
+{
+	SCOPED_EVENT("PhysicsInterpolator - apply");
+
+	for (const Entry& entry : _entries)
+	{
+		if (Entity* entity = entry.entity.get())
+		{
+			const math::Transform& current = std::as_const(*entity).local_transform();
+			entity->set_interpolated_transform(math::Transform::lerp(entry.previous, current, alpha));
+		}
+	}
+}
+
+void PhysicsInterpolator::clear()
+{
+	_entries.clear();
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include <math/transform.h>
+
+#include "entity_handle.h"
+
+class Entity;
+
+// Smooths the transforms of entities moved by the fixed timestep physics group
+// Between frames the world matrices of the entity are built from a blend of the last two physics states,
+// so rendering stays smooth when the frame rate and physics rate don't line up
+// The local transform is never touched, gameplay always reads and writes the simulated state
+class PhysicsInterpolator
+{
+public:
+	PhysicsInterpolator() = default;
+	PhysicsInterpolator(const PhysicsInterpolator&) = delete;
+	PhysicsInterpolator(PhysicsInterpolator&&) = delete;
+
+	void add(Entity& entity);
+
+	// Stops interpolating the entity, leaving it at its latest simulated transform
+	void remove(Entity& entity);
+
+	// Builds world matrices from the simulated transforms again ahead of the physics steps
+	// Entities whose transform was written since it was last blended are treated as teleports and not blended from their old state
+	// Entities that have been destroyed are dropped
+	void restore();
+
+	// Captures the state before a physics step
+	void begin_step();
+
+	// Blends towards the state after the final physics step and hands the result to the world matrices
+	// An alpha of 0 gives the previous physics state and 1 gives the latest
+	void apply(float alpha);
+
+	void clear();
+
+	[[nodiscard]] size_t num_entities() const noexcept { return _entries.size(); }
+
+private:
+	struct Entry
+	{
+		EntityHandle<Entity> entity;
+		math::Transform previous;
+	};
+
+	std::vector<Entry> _entries;
+};
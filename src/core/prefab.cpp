@@ -0,0 +1,323 @@
+#include "prefab.h"
+
+#include <memory/gc.h>
+#include <utils/utils.h>
+#include <profiling/scoped_event.h>
+
+#include "logger.h"
+#include "entity.h"
+#include "component.h"
+#include "entity_factory.h"
+#include "component_factory.h"
+#include "reflection_database.h"
+
+// Keys of a definition that describe its structure rather than member values
+static bool is_structural_key(const std::string& key)
+{
+	return key == "type" || key == "components" || key == "children";
+}
+
+// Copies only the member values out of a definition, leaving an empty archive for inline definitions
+static Archive extract_members(const nlohmann::json& json_def)
+{
+	Archive members;
+	if (!json_def.is_object())
+	{
+		return members;
+	}
+
+	for (const auto& [key, value] : json_def.items())
+	{
+		if (!is_structural_key(key))
+		{
+			members.json_def[key] = value;
+		}
+	}
+
+	return members;
+}
+
+// Applies the values of a plan, converting archive plans into snapshots when capturing
+template <typename T>
+static void apply_plan_members(
+	const peng::weak_ptr<T>& target,
+	const Archive& members,
+	Serializable::MemberSnapshot& snapshot,
+	bool use_snapshot,
+	bool capture
+)
+{
+	if (use_snapshot)
+	{
+		target->apply_members(snapshot);
+		return;
+	}
+
+	if (!members.json_def.empty())
+	{
+		target->deserialize(members);
+	}
+
+	if (capture)
+	{
+		snapshot = target->snapshot_members(members);
+	}
+}
+
+Prefab::Prefab(std::string&& name)
+	: _name(std::move(name))
+	, _snapshots_ready(false)
+{ }
+
+peng::shared_ref<Prefab> Prefab::load_asset(const Archive& archive)
+{
+	SCOPED_EVENT("Prefab - compile", archive.name.c_str());
+
+	peng::shared_ref<Prefab> prefab = memory::GC::alloc<Prefab>(utils::copy(archive.name));
+	if (!prefab->compile_archive(archive, -1))
+	{
+		Logger::error("Prefab '%s' could not be compiled", archive.name.c_str());
+	}
+
+	return prefab;
+}
+
+peng::shared_ref<Prefab> Prefab::from_entity(const Entity& entity)
+{
+	SCOPED_EVENT("Prefab - from entity", entity.name().c_str());
+
+	peng::shared_ref<Prefab> prefab = peng::make_shared<Prefab>(utils::copy(entity.name()));
+	prefab->compile_entity(entity, -1, EntityRelationship::full);
+	prefab->_snapshots_ready = true;
+
+	return prefab;
+}
+
+peng::weak_ptr<Entity> Prefab::instantiate() const
+{
+	std::vector<peng::weak_ptr<Entity>> instances;
+	return instantiate(instances);
+}
+
+std::vector<peng::weak_ptr<Entity>> Prefab::instantiate(size_t count) const
+{
+	SCOPED_EVENT("Prefab - instantiate", strtools::catf_temp("%s x%zu", _name.c_str(), count));
+
+	std::vector<peng::weak_ptr<Entity>> roots;
+	roots.reserve(count);
+
+	std::vector<peng::weak_ptr<Entity>> instances;
+	instances.reserve(_nodes.size());
+
+	for (size_t i = 0; i < count; i++)
+	{
+		roots.push_back(instantiate(instances));
+	}
+
+	return roots;
+}
+
+bool Prefab::compile_archive(const Archive& archive, int32_t parent)
+{
+	const bool inline_def = archive.json_def.is_string();
+	if (!(inline_def || archive.json_def.is_object()))
+	{
+		Logger::error(
+			"Could not compile entity '%s' as it is not a entity typename or definition",
+			archive.json_def.dump().c_str()
+		);
+
+		return false;
+	}
+
+	const std::string entity_type =
+		inline_def
+		? archive.json_def.get<std::string>()
+		: archive.read_or<std::string>("type");
+
+	const peng::shared_ptr<const ReflectedType> reflected_type = ReflectionDatabase::get().reflect_type(entity_type);
+	if (!reflected_type)
+	{
+		Logger::error(
+			"Could not compile entity '%s' as the type '%s' does not exist",
+			archive.name.c_str(), entity_type.c_str()
+		);
+
+		return false;
+	}
+
+	const int32_t node_index = static_cast<int32_t>(_nodes.size());
+	_nodes.push_back(EntityPlan{
+		.type = reflected_type.to_shared_ref(),
+		.name = archive.name,
+		.members = extract_members(archive.json_def),
+		.parent = parent,
+		.relationship = parent >= 0 ? EntityFactory::load_relationship(archive) : EntityRelationship::full,
+		.first_component = _components.size(),
+		.num_components = 0
+	});
+
+	if (inline_def)
+	{
+		return true;
+	}
+
+	if (const auto it = archive.json_def.find("components"); it != archive.json_def.end() && it->is_array())
+	{
+		for (const auto& component_def : *it)
+		{
+			const bool inline_component = component_def.is_string();
+			const std::string component_type =
+				inline_component
+				? component_def.get<std::string>()
+				: component_def.value("type", std::string());
+
+			const peng::shared_ptr<const ReflectedType> reflected_component = ReflectionDatabase::get().reflect_type(component_type);
+			if (!reflected_component)
+			{
+				Logger::error(
+					"Could not compile component '%s' on entity '%s' as the type does not exist",
+					component_type.c_str(), archive.name.c_str()
+				);
+
+				continue;
+			}
+
+			_components.push_back(ComponentPlan{
+				.type = reflected_component.to_shared_ref(),
+				.members = extract_members(component_def),
+				.created_by_owner = false
+			});
+
+			_nodes[node_index].num_components++;
+		}
+	}
+
+	if (const auto it = archive.json_def.find("children"); it != archive.json_def.end() && it->is_array())
+	{
+		for (const auto& child_def : *it)
+		{
+			Archive child_archive;
+			child_archive.json_def = child_def;
+			child_archive.name = child_archive.read_or<std::string>("name");
+
+			compile_archive(child_archive, node_index);
+		}
+	}
+
+	return true;
+}
+
+void Prefab::compile_entity(const Entity& entity, int32_t parent, EntityRelationship relationship)
+{
+	const int32_t node_index = static_cast<int32_t>(_nodes.size());
+	_nodes.push_back(EntityPlan{
+		.type = entity.type(),
+		.name = entity.name(),
+		.snapshot = entity.snapshot_members(),
+		.parent = parent,
+		.relationship = relationship,
+		.first_component = _components.size(),
+		.num_components = entity.components().size()
+	});
+
+	for (const peng::shared_ref<Component>& component : entity.components())
+	{
+		_components.push_back(ComponentPlan{
+			.type = component->type(),
+			.snapshot = component->snapshot_members(),
+			.created_by_owner = component->created_by_owner()
+		});
+	}
+
+	// Children the entity creates for itself are created again by the instance
+	for (const EntityHandle<Entity>& child : entity.children())
+	{
+		const Entity* child_entity = child.get();
+		if (child_entity && !child_entity->created_by_parent())
+		{
+			compile_entity(*child_entity, node_index, child_entity->parent_relationship());
+		}
+	}
+}
+
+peng::weak_ptr<Entity> Prefab::instantiate(std::vector<peng::weak_ptr<Entity>>& instances) const
+{
+	instances.clear();
+
+	// The first instance captures the snapshots while reading the archives, other threads that
+	// instantiate meanwhile read the archives themselves rather than waiting on it
+	bool use_snapshots = _snapshots_ready.load(std::memory_order_acquire);
+	std::unique_lock capture_lock(_snapshot_lock, std::defer_lock);
+	if (!use_snapshots && capture_lock.try_lock())
+	{
+		use_snapshots = _snapshots_ready.load(std::memory_order_relaxed);
+	}
+
+	const bool capture = capture_lock.owns_lock() && !use_snapshots;
+
+	std::vector<bool> claimed_components;
+
+	for (const EntityPlan& node : _nodes)
+	{
+		peng::weak_ptr<Entity> entity = EntityFactory::get().create_entity(node.type, node.name);
+		instances.push_back(entity);
+
+		if (!entity)
+		{
+			// Children of a node that failed to be created are skipped along with it
+			continue;
+		}
+
+		apply_plan_members(entity, node.members, node.snapshot, use_snapshots, capture);
+
+		// Components the owner creates in post_create don't exist yet, so they keep the values the type gives them
+		// The owner may add its components in any order, so each plan claims the first unclaimed one of its type
+		const size_t num_constructed_components = entity->components().size();
+		claimed_components.assign(num_constructed_components, false);
+
+		for (size_t i = node.first_component; i < node.first_component + node.num_components; i++)
+		{
+			const ComponentPlan& component_plan = _components[i];
+			peng::weak_ptr<Component> component;
+
+			if (component_plan.created_by_owner)
+			{
+				for (size_t j = 0; j < num_constructed_components; j++)
+				{
+					const peng::shared_ref<Component>& own_component = entity->components()[j];
+					if (!claimed_components[j] && own_component->type()->component_id == component_plan.type->component_id)
+					{
+						claimed_components[j] = true;
+						component = own_component;
+						break;
+					}
+				}
+			}
+			else
+			{
+				component = ComponentFactory::get().create_component(component_plan.type, entity);
+			}
+
+			if (component)
+			{
+				apply_plan_members(component, component_plan.members, component_plan.snapshot, use_snapshots, capture);
+			}
+		}
+
+		if (node.parent >= 0)
+		{
+			if (const peng::weak_ptr<Entity>& parent = instances[node.parent])
+			{
+				entity->set_parent(parent, node.relationship);
+			}
+		}
+	}
+
+	if (capture)
+	{
+		_snapshots_ready.store(true, std::memory_order_release);
+	}
+
+	return instances.empty() ? peng::weak_ptr<Entity>() : instances.front();
+}
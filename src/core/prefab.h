@@ -0,0 +1,85 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include <memory/shared_ref.h>
+#include <memory/weak_ptr.h>
+
+#include "archive.h"
+#include "serializable.h"
+#include "entity_relationship.h"
+
+struct ReflectedType;
+class Entity;
+
+// Entity definition compiled once into a flat construction plan so that it can be instantiated repeatedly
+// Types are resolved and the member values of each entity and component are split out of the definition
+// up front, so instantiating never has to walk or search the original definition
+// Member values are applied as typed snapshots, archive definitions are only read for the first instance
+class Prefab
+{
+public:
+	explicit Prefab(std::string&& name);
+
+	Prefab(const Prefab&) = delete;
+	Prefab(Prefab&&) = delete;
+
+	static peng::shared_ref<Prefab> load_asset(const Archive& archive);
+
+	// Builds a prefab from the current state of an entity, its components and its children
+	[[nodiscard]] static peng::shared_ref<Prefab> from_entity(const Entity& entity);
+
+	// Creates a new copy of the prefab, the root entity has no parent
+	// Returns nullptr if the root entity could not be created
+	[[nodiscard]] peng::weak_ptr<Entity> instantiate() const;
+
+	// Creates many copies of the prefab at once, reusing the same scratch state for every copy
+	[[nodiscard]] std::vector<peng::weak_ptr<Entity>> instantiate(size_t count) const;
+
+	[[nodiscard]] const std::string& name() const noexcept { return _name; }
+	[[nodiscard]] size_t num_entities() const noexcept { return _nodes.size(); }
+
+private:
+	struct ComponentPlan
+	{
+		peng::shared_ref<const ReflectedType> type;
+		Archive members = {};
+		mutable Serializable::MemberSnapshot snapshot = {};
+
+		// The owner adds the component itself, so the values are applied to its own component instead of a new one
+		bool created_by_owner = false;
+	};
+
+	struct EntityPlan
+	{
+		peng::shared_ref<const ReflectedType> type;
+		std::string name = {};
+		Archive members = {};
+		mutable Serializable::MemberSnapshot snapshot = {};
+
+		// Index of the parent within the plan, or -1 for the root
+		// Parents always precede their children
+		int32_t parent = -1;
+		EntityRelationship relationship = EntityRelationship::full;
+
+		size_t first_component = 0;
+		size_t num_components = 0;
+	};
+
+	// Returns false if the definition couldn't be compiled
+	bool compile_archive(const Archive& archive, int32_t parent);
+	void compile_entity(const Entity& entity, int32_t parent, EntityRelationship relationship);
+
+	peng::weak_ptr<Entity> instantiate(std::vector<peng::weak_ptr<Entity>>& instances) const;
+
+	std::string _name;
+	std::vector<EntityPlan> _nodes;
+	std::vector<ComponentPlan> _components;
+
+	// Set once every plan holds a snapshot, until then the first instance fills them in from the archives
+	mutable std::atomic<bool> _snapshots_ready;
+	mutable std::mutex _snapshot_lock;
+};
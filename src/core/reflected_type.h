@@ -1,12 +1,24 @@
 #pragma once
 
 #include <string>
+#include <cstdint>
 #include <typeinfo>
 
+#include "tick_access.h"
+
 struct ReflectedType
 {
 	std::string name;
 	bool is_abstract = false;
+
+	// False if the type never overrides the no-op tick of its root class, so can be skipped when ticking
+	bool has_tick = true;
+
+	// Data accessed by the type while ticking, exclusive unless the type declares otherwise
+	TickAccess tick_access;
+
+	// Dense component type id, or -1 if the type isn't a component
+	int32_t component_id = -1;
 	const std::type_info* info = nullptr;
 	const std::type_info* base_info = nullptr;
 };
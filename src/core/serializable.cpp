@@ -1,5 +1,7 @@
 #include "serializable.h"
 
+#include <utils/check.h>
+
 #include "archive.h"
 
 void Serializable::serialize(Archive& archive) const
@@ -18,6 +20,47 @@ void Serializable::deserialize(const Archive& archive)
 	}
 }
 
+Serializable::MemberSnapshot Serializable::snapshot_members() const
+{
+	MemberSnapshot snapshot;
+	snapshot.reserve(_copiers.size());
+
+	for (size_t i = 0; i < _copiers.size(); i++)
+	{
+		snapshot.push_back(MemberValue{ i, _copiers[i].capture() });
+	}
+
+	return snapshot;
+}
+
+Serializable::MemberSnapshot Serializable::snapshot_members(const Archive& archive) const
+{
+	MemberSnapshot snapshot;
+	if (!archive.json_def.is_object())
+	{
+		return snapshot;
+	}
+
+	for (size_t i = 0; i < _copiers.size(); i++)
+	{
+		if (archive.json_def.contains(_copiers[i].name))
+		{
+			snapshot.push_back(MemberValue{ i, _copiers[i].capture() });
+		}
+	}
+
+	return snapshot;
+}
+
+void Serializable::apply_members(const MemberSnapshot& snapshot)
+{
+	for (const MemberValue& member_value : snapshot)
+	{
+		check(member_value.member < _copiers.size());
+		_copiers[member_value.member].apply(member_value.value);
+	}
+}
+
 void Serializable::add_serializer(std::function<void(Archive& archive)>&& serializer)
 {
 	_serializers.push_back(serializer);
@@ -26,4 +69,13 @@ void Serializable::add_serializer(std::function<void(Archive& archive)>&& serial
 void Serializable::add_deserializer(std::function<void(const Archive& archive)>&& deserializer)
 {
 	_deserializers.push_back(deserializer);
+}
+
+void Serializable::add_member_copier(
+	std::string&& name,
+	std::function<std::any()>&& capture,
+	std::function<void(const std::any& value)>&& apply
+)
+{
+	_copiers.push_back(MemberCopier{ std::move(name), std::move(capture), std::move(apply) });
 }
\ No newline at end of file
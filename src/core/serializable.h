@@ -1,5 +1,7 @@
 #pragma once
 
+#include <any>
+#include <string>
 #include <vector>
 #include <functional>
 
@@ -8,6 +10,16 @@ struct Archive;
 class Serializable
 {
 public:
+    // Typed copies of serialized member values, which can be applied to another object of the same type
+    // without converting the values to and from an archive
+    struct MemberValue
+    {
+        size_t member;
+        std::any value;
+    };
+
+    using MemberSnapshot = std::vector<MemberValue>;
+
     Serializable() = default;
     virtual ~Serializable() = default;
 
@@ -15,11 +27,32 @@ public:
     virtual void serialize(Archive& archive) const;
     virtual void deserialize(const Archive& archive);
 
+    // Copies every serialized member
+    [[nodiscard]] MemberSnapshot snapshot_members() const;
+
+    // Copies only the serialized members that the archive has a value for
+    [[nodiscard]] MemberSnapshot snapshot_members(const Archive& archive) const;
+
+    void apply_members(const MemberSnapshot& snapshot);
+
 protected:
     void add_serializer(std::function<void(Archive& archive)>&& serializer);
     void add_deserializer(std::function<void(const Archive& archive)>&& deserializer);
+    void add_member_copier(
+        std::string&& name,
+        std::function<std::any()>&& capture,
+        std::function<void(const std::any& value)>&& apply
+    );
 
 private:
+    struct MemberCopier
+    {
+        std::string name;
+        std::function<std::any()> capture;
+        std::function<void(const std::any& value)> apply;
+    };
+
     std::vector<std::function<void(Archive& archive)>> _serializers;
     std::vector<std::function<void(const Archive& archive)>> _deserializers;
-};
+    std::vector<MemberCopier> _copiers;
+};
\ No newline at end of file
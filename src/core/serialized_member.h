@@ -1,6 +1,8 @@
 #pragma once
 
+#include <any>
 #include <string_view>
+#include <type_traits>
 
 #include "archive.h"
 
@@ -40,4 +42,11 @@ namespace detail
         {                                                                                           \
             archive.try_read(name.c_str(), member);                                                 \
         });                                                                                         \
+                                                                                                    \
+        add_member_copier(std::string(__PE_name),                                                   \
+            [this] { return std::any(member); },                                                    \
+            [this](const std::any& value)                                                           \
+            {                                                                                       \
+                member = std::any_cast<const std::remove_cvref_t<decltype(member)>&>(value);        \
+            });                                                                                     \
     } while(0)
\ No newline at end of file
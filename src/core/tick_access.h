@@ -0,0 +1,42 @@
+#pragma once
+
+#include <utils/enum_flags.h>
+
+// Categories of shared engine data that may be touched while ticking
+enum class DataDomain
+{
+	transforms = 1 << 0,
+	physics = 1 << 1,
+	render_queue = 1 << 2,
+
+	none = 0,
+	all = ~0
+};
+
+ENUM_FLAGS(DataDomain)
+
+// Describes the data a type reads and writes during tick so that the tick scheduler
+// can run types with non-conflicting access concurrently within a tick group
+//
+// Types opt in by declaring 'static constexpr TickAccess tick_access = { ... };'
+// Types without a declaration are treated as exclusive and never tick alongside anything else
+//
+// The shipped types that declare access all move their owner, so they write transforms and still
+// conflict with one another, only types that leave transforms alone can share a wave with them
+struct TickAccess
+{
+	DataDomain reads = DataDomain::all;
+	DataDomain writes = DataDomain::all;
+
+	// If instances of the type only touch their own state (or that of their owner)
+	// and so can tick concurrently with each other
+	// Such types must not write the hierarchy, which includes moving an entity through the non-const
+	// local_transform() since that invalidates the cached world transforms of its children
+	bool parallel_instances = false;
+
+	[[nodiscard]] constexpr bool conflicts_with(const TickAccess& other) const noexcept
+	{
+		return (writes & (other.reads | other.writes)) != DataDomain::none
+			|| (other.writes & reads) != DataDomain::none;
+	}
+};
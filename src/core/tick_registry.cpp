@@ -0,0 +1,136 @@
+#include "tick_registry.h"
+
+#include <utils/check.h>
+
+#include "reflected_type.h"
+
+void TickRegistry::add(ITickable& tickable, const ReflectedType* type)
+{
+	check(!tickable.tick_registered());
+	check(tickable.tick_group() != TickGroup::none);
+
+	Group& group = _groups[static_cast<int32_t>(tickable.tick_group())];
+	group.num_tickables++;
+
+	tickable._tick_phase = group.next_phase++;
+	tickable._last_tick_time = group.clock.time;
+	tickable.reset_tick_stagger(group.clock.time);
+
+	if (tickable.tick_priority() == TickPriority::low)
+	{
+		tickable._tick_bucket = low_priority_bucket;
+		tickable._tick_index = static_cast<int32_t>(group.low_priority.tickables.size());
+		group.low_priority.tickables.push_back(&tickable);
+		return;
+	}
+
+	// Buckets are never removed once created so that bucket indices remain stable
+	auto [it, inserted] = group.bucket_lookup.try_emplace(type, static_cast<int32_t>(group.buckets.size()));
+	if (inserted)
+	{
+		TickBucket& bucket = group.buckets.emplace_back();
+		bucket.type = type;
+		bucket.access = type ? type->tick_access : TickAccess();
+	}
+
+	TickBucket& bucket = group.buckets[it->second];
+	tickable._tick_bucket = it->second;
+	tickable._tick_index = static_cast<int32_t>(bucket.tickables.size());
+	bucket.tickables.push_back(&tickable);
+}
+
+void TickRegistry::remove(ITickable& tickable)
+{
+	check(tickable.tick_registered());
+
+	Group& group = _groups[static_cast<int32_t>(tickable.tick_group())];
+	std::vector<ITickable*>& tickables = tickable._tick_bucket == low_priority_bucket
+		? group.low_priority.tickables
+		: group.buckets[tickable._tick_bucket].tickables;
+
+	const int32_t index = tickable._tick_index;
+	check(tickables[index] == &tickable);
+
+	// Swap remove, patching the index of the tickable that was moved
+	ITickable* last = tickables.back();
+	tickables[index] = last;
+	last->_tick_index = index;
+	tickables.pop_back();
+	group.num_tickables--;
+
+	tickable._tick_bucket = -1;
+	tickable._tick_index = -1;
+}
+
+void TickRegistry::clear()
+{
+	for (Group& group : _groups)
+	{
+		for (TickBucket& bucket : group.buckets)
+		{
+			for (ITickable* tickable : bucket.tickables)
+			{
+				tickable->_tick_bucket = -1;
+				tickable->_tick_index = -1;
+			}
+		}
+
+		for (ITickable* tickable : group.low_priority.tickables)
+		{
+			tickable->_tick_bucket = -1;
+			tickable->_tick_index = -1;
+		}
+
+		group.buckets.clear();
+		group.bucket_lookup.clear();
+		group.low_priority = {};
+		group.num_tickables = 0;
+	}
+}
+
+const TickClock& TickRegistry::advance_clock(TickGroup tick_group, float delta_time) noexcept
+{
+	check(tick_group != TickGroup::none);
+
+	TickClock& clock = _groups[static_cast<int32_t>(tick_group)].clock;
+	clock.ticks++;
+	clock.time += delta_time;
+	clock.delta_time = delta_time;
+
+	return clock;
+}
+
+const std::vector<TickBucket>& TickRegistry::buckets(TickGroup tick_group) const noexcept
+{
+	check(tick_group != TickGroup::none);
+	return _groups[static_cast<int32_t>(tick_group)].buckets;
+}
+
+TickSlice& TickRegistry::low_priority(TickGroup tick_group) noexcept
+{
+	check(tick_group != TickGroup::none);
+	return _groups[static_cast<int32_t>(tick_group)].low_priority;
+}
+
+const TickClock& TickRegistry::clock(TickGroup tick_group) const noexcept
+{
+	check(tick_group != TickGroup::none);
+	return _groups[static_cast<int32_t>(tick_group)].clock;
+}
+
+size_t TickRegistry::num_tickables(TickGroup tick_group) const noexcept
+{
+	check(tick_group != TickGroup::none);
+	return _groups[static_cast<int32_t>(tick_group)].num_tickables;
+}
+
+size_t TickRegistry::num_tickables() const noexcept
+{
+	size_t count = 0;
+	for (const Group& group : _groups)
+	{
+		count += group.num_tickables;
+	}
+
+	return count;
+}
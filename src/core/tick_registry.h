@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <unordered_map>
+
+#include "tickable.h"
+#include "tick_access.h"
+
+struct ReflectedType;
+
+// All registered tickables of a single type within a tick group
+struct TickBucket
+{
+	const ReflectedType* type = nullptr;
+	TickAccess access;
+	std::vector<ITickable*> tickables;
+};
+
+// Low priority tickables of a tick group, ticked in turn while the group's budget allows
+struct TickSlice
+{
+	std::vector<ITickable*> tickables;
+
+	// Index of the tickable to resume from next time
+	size_t cursor = 0;
+};
+
+// Persistent per tick group lists of everything that should currently be ticked
+// Tickables are added and removed incrementally so that ticking a group is a linear walk
+// Within a group, tickables are bucketed by type so the scheduler can reason about their data access
+class TickRegistry
+{
+public:
+	TickRegistry() = default;
+	TickRegistry(const TickRegistry&) = delete;
+	TickRegistry(TickRegistry&&) = delete;
+
+	// Tickables without a type are placed in their own bucket and treated as exclusive
+	// Low priority tickables are kept apart from the buckets in the group's slice
+	void add(ITickable& tickable, const ReflectedType* type);
+
+	// Swaps the last tickable of the bucket into the removed slot, so tickables within a bucket
+	// don't keep the order they were added in once anything has been removed
+	void remove(ITickable& tickable);
+	void clear();
+
+	// Advances the clock of a group ahead of ticking it
+	const TickClock& advance_clock(TickGroup tick_group, float delta_time) noexcept;
+
+	[[nodiscard]] const std::vector<TickBucket>& buckets(TickGroup tick_group) const noexcept;
+	[[nodiscard]] TickSlice& low_priority(TickGroup tick_group) noexcept;
+	[[nodiscard]] const TickClock& clock(TickGroup tick_group) const noexcept;
+	[[nodiscard]] size_t num_tickables(TickGroup tick_group) const noexcept;
+	[[nodiscard]] size_t num_tickables() const noexcept;
+
+private:
+	// Bucket index used by tickables held in the low priority slice
+	static constexpr int32_t low_priority_bucket = -2;
+
+	struct Group
+	{
+		std::vector<TickBucket> buckets;
+		std::unordered_map<const ReflectedType*, int32_t> bucket_lookup;
+		TickSlice low_priority;
+		TickClock clock;
+		size_t num_tickables = 0;
+
+		// Handed out in turn so that throttled tickables are staggered against each other
+		uint32_t next_phase = 0;
+	};
+
+	std::array<Group, num_tick_groups> _groups;
+};
@@ -0,0 +1,195 @@
+#include "tick_scheduler.h"
+
+#include <chrono>
+#include <algorithm>
+
+#include <profiling/scoped_event.h>
+#include <utils/strtools.h>
+#include <threading/job_system.h>
+
+#include "entity_command_queue.h"
+
+namespace
+{
+	thread_local bool ticking_split_bucket = false;
+}
+
+void TickScheduler::tick_group(const std::vector<TickBucket>& buckets, bool parallel_group, const TickClock& clock)
+{
+	build_waves(buckets, parallel_group);
+	_next_order = 0;
+
+	for (size_t wave_index = 0; wave_index < _num_waves; wave_index++)
+	{
+		tick_wave(_waves[wave_index], parallel_group, clock);
+	}
+}
+
+size_t TickScheduler::tick_slice(TickSlice& slice, const TickClock& clock, float budget_ms)
+{
+	const size_t count = slice.tickables.size();
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	SCOPED_EVENT("TickScheduler - tick slice");
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto budget = std::chrono::duration<float, std::milli>(budget_ms);
+
+	size_t visited = 0;
+	while (visited < count)
+	{
+		// Tickables removed since the last call may have left the cursor past the end
+		if (slice.cursor >= slice.tickables.size())
+		{
+			slice.cursor = 0;
+		}
+
+		tick_tickable(*slice.tickables[slice.cursor++], clock);
+		visited++;
+
+		if (budget_ms > 0 && std::chrono::steady_clock::now() - start >= budget)
+		{
+			break;
+		}
+	}
+
+	return visited;
+}
+
+void TickScheduler::tick_tickable(ITickable& tickable, const TickClock& clock)
+{
+	float delta_time;
+	if (tickable.consume_tick(clock, delta_time))
+	{
+		tickable.tick(delta_time);
+	}
+}
+
+bool TickScheduler::ticking_instances_concurrently() noexcept
+{
+	return ticking_split_bucket;
+}
+
+void TickScheduler::set_pre_concurrent_wave(std::function<void()>&& callback)
+{
+	_pre_concurrent_wave = std::move(callback);
+}
+
+void TickScheduler::set_post_concurrent_wave(std::function<void()>&& callback)
+{
+	_post_concurrent_wave = std::move(callback);
+}
+
+void TickScheduler::build_waves(const std::vector<TickBucket>& buckets, bool parallel_group)
+{
+	// Wave storage is reused between frames to avoid reallocating
+	for (size_t wave_index = 0; wave_index < _num_waves; wave_index++)
+	{
+		_waves[wave_index].clear();
+	}
+
+	_num_waves = 0;
+
+	for (const TickBucket& bucket : buckets)
+	{
+		if (bucket.tickables.empty())
+		{
+			continue;
+		}
+
+		// Place the bucket in the first wave that it doesn't conflict with
+		size_t wave_index = 0;
+		if (!parallel_group)
+		{
+			for (; wave_index < _num_waves; wave_index++)
+			{
+				const bool conflicts = std::ranges::any_of(_waves[wave_index], [&](const TickBucket* other)
+				{
+					return bucket.access.conflicts_with(other->access);
+				});
+
+				if (!conflicts)
+				{
+					break;
+				}
+			}
+		}
+
+		if (wave_index == _num_waves)
+		{
+			if (_waves.size() == _num_waves)
+			{
+				_waves.emplace_back();
+			}
+
+			_num_waves++;
+		}
+
+		_waves[wave_index].push_back(&bucket);
+	}
+}
+
+void TickScheduler::tick_wave(const std::vector<const TickBucket*>& wave, bool parallel_group, const TickClock& clock)
+{
+	SCOPED_EVENT("TickScheduler - tick wave", strtools::catf_temp("%zu buckets", wave.size()));
+
+	// A single exclusive bucket gains nothing from being dispatched to other threads
+	if (wave.size() == 1 && !parallel_group && !wave.front()->access.parallel_instances)
+	{
+		for (ITickable* tickable : wave.front()->tickables)
+		{
+			tick_tickable(*tickable, clock);
+		}
+
+		_next_order += wave.front()->tickables.size();
+		return;
+	}
+
+	_work_items.clear();
+	for (const TickBucket* bucket : wave)
+	{
+		ITickable* const* tickables = bucket->tickables.data();
+		const size_t count = bucket->tickables.size();
+
+		if (parallel_group || bucket->access.parallel_instances)
+		{
+			for (size_t offset = 0; offset < count; offset += batch_size)
+			{
+				_work_items.push_back({ tickables + offset, tickables + std::min(offset + batch_size, count), _next_order + offset, true });
+			}
+		}
+		else
+		{
+			_work_items.push_back({ tickables, tickables + count, _next_order, false });
+		}
+
+		_next_order += count;
+	}
+
+	if (_pre_concurrent_wave)
+	{
+		_pre_concurrent_wave();
+	}
+
+	threading::JobSystem::get().parallel_for(_work_items, 1, [&clock](const WorkItem& item)
+	{
+		ticking_split_bucket = item.split;
+
+		for (ITickable* const* tickable = item.begin; tickable < item.end; tickable++)
+		{
+			// Structural changes are merged in dispatch order so the outcome doesn't depend on thread scheduling
+			EntityCommandQueue::set_issue_order(item.first_order + (tickable - item.begin));
+			tick_tickable(**tickable, clock);
+		}
+
+		ticking_split_bucket = false;
+	});
+
+	if (_post_concurrent_wave)
+	{
+		_post_concurrent_wave();
+	}
+}
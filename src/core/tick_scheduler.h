@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+
+#include "tick_registry.h"
+
+// Ticks the buckets of a tick group, running buckets with non-conflicting data access concurrently
+// Buckets are greedily packed into waves where no two buckets conflict, and waves run one after another
+//
+// Tickables run bucket by bucket, so within a group every tickable of one type ticks before those of the next
+// rather than each entity ticking its components together. Code must not rely on the relative order of
+// different types within a group. Groups themselves still tick one after another with a flush in between
+class TickScheduler
+{
+public:
+	// Maximum number of tickables processed by a single work item when a bucket is split up
+	static constexpr size_t batch_size = 32;
+
+	TickScheduler() = default;
+	TickScheduler(const TickScheduler&) = delete;
+	TickScheduler(TickScheduler&&) = delete;
+
+	// Ticks every bucket of a group, a parallel group ticks all of its tickables concurrently regardless of access
+	void tick_group(const std::vector<TickBucket>& buckets, bool parallel_group, const TickClock& clock);
+
+	// Ticks low priority tickables on the calling thread, starting from where the previous call stopped
+	// Stops once the budget has been used up, a budget of 0 or less ticks every tickable
+	// Returns the number of tickables that were visited
+	size_t tick_slice(TickSlice& slice, const TickClock& clock, float budget_ms);
+
+	// Ticks the tickable if its tick rate allows
+	static void tick_tickable(ITickable& tickable, const TickClock& clock);
+
+	// True while the calling thread is ticking a tickable alongside other instances of the same type
+	[[nodiscard]] static bool ticking_instances_concurrently() noexcept;
+
+	// Invoked on the calling thread before any wave is dispatched concurrently, allowing
+	// lazily computed shared state to be resolved so that it isn't built by several threads at once
+	void set_pre_concurrent_wave(std::function<void()>&& callback);
+
+	// Invoked on the calling thread once a concurrent wave has finished
+	void set_post_concurrent_wave(std::function<void()>&& callback);
+
+private:
+	struct WorkItem
+	{
+		ITickable* const* begin;
+		ITickable* const* end;
+
+		// Dispatch order of the first tickable within the tick group
+		uint64_t first_order;
+
+		// If the bucket was split up, so the tickables run concurrently with others of their type
+		bool split;
+	};
+
+	void build_waves(const std::vector<TickBucket>& buckets, bool parallel_group);
+	void tick_wave(const std::vector<const TickBucket*>& wave, bool parallel_group, const TickClock& clock);
+
+	std::vector<std::vector<const TickBucket*>> _waves;
+	size_t _num_waves = 0;
+
+	std::vector<WorkItem> _work_items;
+	uint64_t _next_order = 0;
+
+	std::function<void()> _pre_concurrent_wave;
+	std::function<void()> _post_concurrent_wave;
+};
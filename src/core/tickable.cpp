@@ -1,27 +1,86 @@
 #include "tickable.h"
 
+#include <cmath>
+#include <algorithm>
+
+#include <utils/check.h>
+
+void ITickable::set_tick_rate(const TickRate& tick_rate) noexcept
+{
+	check(tick_rate.interval_ticks > 0);
+	check(tick_rate.interval_seconds >= 0);
+
+	_tick_rate = tick_rate;
+	reset_tick_stagger(std::max(_last_tick_time, 0.0));
+}
+
+void ITickable::set_tick_priority(TickPriority tick_priority) noexcept
+{
+	check(!tick_registered());
+	_tick_priority = tick_priority;
+}
+
+bool ITickable::consume_tick(const TickClock& clock, float& delta_time) noexcept
+{
+	if (_tick_rate.interval_ticks > 1 && (clock.ticks + _tick_phase) % _tick_rate.interval_ticks != 0)
+	{
+		return false;
+	}
+
+	if (_tick_rate.interval_seconds > 0)
+	{
+		if (clock.time < _next_tick_time)
+		{
+			return false;
+		}
+
+		// Tickables that fell behind don't try to catch up on the ticks they missed
+		_next_tick_time += _tick_rate.interval_seconds;
+		if (_next_tick_time <= clock.time)
+		{
+			_next_tick_time = clock.time + _tick_rate.interval_seconds;
+		}
+	}
+
+	delta_time = _last_tick_time < 0
+		? clock.delta_time
+		: static_cast<float>(clock.time - _last_tick_time);
+
+	_last_tick_time = clock.time;
+	return true;
+}
+
+void ITickable::reset_tick_stagger(double time) noexcept
+{
+	// Consecutive phases land far apart within the interval so any number of tickables are spread evenly
+	constexpr double golden_ratio_conjugate = 0.6180339887;
+
+	const double offset = std::fmod(_tick_phase * golden_ratio_conjugate, 1.0);
+	_next_tick_time = time + _tick_rate.interval_seconds * offset;
+}
+
 std::ostream& operator<<(std::ostream& os, TickGroup tick_group)
 {
-    switch (tick_group)
-    {
-        case TickGroup::standard:        os << "standard";        break;
-        case TickGroup::physics:         os << "physics";         break;
-        case TickGroup::pre_render:      os << "pre_render";      break;
-        case TickGroup::render:          os << "render";          break;
-        case TickGroup::render_parallel: os << "render_parallel"; break;
-        case TickGroup::post_render:     os << "post_render";     break;
-        case TickGroup::none:            os << "none";            break;
-        default: os << "???"; break;
-    }
-
-    return os;
+	switch (tick_group)
+	{
+		case TickGroup::standard:        os << "standard";        break;
+		case TickGroup::physics:         os << "physics";         break;
+		case TickGroup::pre_render:      os << "pre_render";      break;
+		case TickGroup::render:          os << "render";          break;
+		case TickGroup::render_parallel: os << "render_parallel"; break;
+		case TickGroup::post_render:     os << "post_render";     break;
+		case TickGroup::none:            os << "none";            break;
+		default: os << "???"; break;
+	}
+
+	return os;
 }
 
 bool is_parallel_tick_group(TickGroup tick_group)
 {
-    switch (tick_group)
-    {
-        case TickGroup::render_parallel: return true;
-        default: return false;
-    }
+	switch (tick_group)
+	{
+		case TickGroup::render_parallel: return true;
+		default: return false;
+	}
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ostream>
+#include <cstdint>
 
 enum class TickGroup
 {
@@ -14,11 +15,84 @@ enum class TickGroup
 	none
 };
 
+constexpr int32_t num_tick_groups = static_cast<int32_t>(TickGroup::none);
+
+enum class TickPriority
+{
+	normal,
+
+	// Ticked after everything else in the group, and only while the group's tick budget allows
+	low
+};
+
+// How often a tickable wants to tick
+// Both limits apply, so a tickable with an interval of 2 ticks and 0.1 seconds ticks on
+// every other tick of its group once at least 0.1 seconds have passed
+struct TickRate
+{
+	// Ticks on one out of every this many ticks of the group
+	int32_t interval_ticks = 1;
+
+	// Minimum time between ticks in seconds
+	float interval_seconds = 0;
+
+	[[nodiscard]] constexpr bool every_tick() const noexcept { return interval_ticks <= 1 && interval_seconds <= 0; }
+};
+
+// Running clock of a tick group, advanced once each time the group ticks
+struct TickClock
+{
+	uint64_t ticks = 0;
+	double time = 0;
+	float delta_time = 0;
+};
+
 class ITickable
 {
+	friend class TickRegistry;
+	friend class TickScheduler;
+
 public:
 	virtual void tick(float delta_time) = 0;
 	[[nodiscard]] virtual TickGroup tick_group() const noexcept = 0;
+
+	// Throttled tickables are passed all of the time since they last ticked
+	// Tickables sharing a rate are staggered so their ticks are spread evenly over the ticks of the group
+	// Components in archetype storage are only staggered if they were already throttled when their entity was created
+	void set_tick_rate(const TickRate& tick_rate) noexcept;
+	[[nodiscard]] const TickRate& tick_rate() const noexcept { return _tick_rate; }
+
+	// Must be set before the tickable is first registered for ticking
+	// Components in archetype storage must have it set before their entity is created
+	void set_tick_priority(TickPriority tick_priority) noexcept;
+	[[nodiscard]] TickPriority tick_priority() const noexcept { return _tick_priority; }
+
+	// Throttled and low priority tickables rely on the tick registry for their stagger and budget
+	[[nodiscard]] bool tick_scheduled() const noexcept
+	{
+		return !_tick_rate.every_tick() || _tick_priority != TickPriority::normal;
+	}
+
+	[[nodiscard]] bool tick_registered() const noexcept { return _tick_index >= 0; }
+
+private:
+	// Returns true if the tickable is due to tick, along with the time since it last ticked
+	bool consume_tick(const TickClock& clock, float& delta_time) noexcept;
+
+	// Spreads the first tick of time-limited tickables over their interval based on their phase
+	void reset_tick_stagger(double time) noexcept;
+
+	// Position of the tickable within the tick registry, or -1 if not registered
+	int32_t _tick_bucket = -1;
+	int32_t _tick_index = -1;
+
+	TickRate _tick_rate;
+	TickPriority _tick_priority = TickPriority::normal;
+	uint32_t _tick_phase = 0;
+
+	// Group time of the last tick, negative until the tickable first ticks or is registered
+	double _last_tick_time = -1;
+	double _next_tick_time = 0;
 };
 
 std::ostream& operator<<(std::ostream& os, TickGroup tick_group);
@@ -0,0 +1,60 @@
+#include "timer_subsystem.h"
+
+#include <cmath>
+#include <algorithm>
+
+#include <profiling/scoped_event.h>
+#include <profiling/counter.h>
+
+TimerSubsystem::TimerSubsystem()
+	: Subsystem()
+	, _time(0)
+{ }
+
+void TimerSubsystem::start()
+{ }
+
+void TimerSubsystem::shutdown()
+{
+	_timers.clear();
+}
+
+void TimerSubsystem::tick(float delta_time)
+{
+	SCOPED_EVENT("TimerSubsystem - tick");
+
+	_time += delta_time;
+	_timers.advance_to(static_cast<uint64_t>(_time / resolution));
+
+	SET_COUNTER("TimerSubsystem - timers", _timers.num_timers());
+}
+
+TimerHandle TimerSubsystem::after(float seconds, Callback&& callback)
+{
+	return _timers.schedule(ticks_until(seconds), std::move(callback));
+}
+
+TimerHandle TimerSubsystem::every(float interval, Callback&& callback)
+{
+	check(interval > 0);
+
+	const uint64_t interval_ticks = std::max<uint64_t>(static_cast<uint64_t>(std::llround(interval / resolution)), 1);
+	return _timers.schedule(ticks_until(interval), std::move(callback), interval_ticks);
+}
+
+bool TimerSubsystem::cancel(TimerHandle handle)
+{
+	return _timers.cancel(handle);
+}
+
+bool TimerSubsystem::pending(TimerHandle handle) const noexcept
+{
+	return _timers.pending(handle);
+}
+
+uint64_t TimerSubsystem::ticks_until(float seconds) const noexcept
+{
+	// Measured from the current time rather than the current tick of the wheel so that sub-tick remainders aren't lost
+	const uint64_t due_tick = static_cast<uint64_t>(std::ceil((_time + seconds) / resolution));
+	return due_tick > _timers.current_tick() ? due_tick - _timers.current_tick() : 1;
+}
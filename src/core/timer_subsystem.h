@@ -0,0 +1,49 @@
+#pragma once
+
+#include <functional>
+
+#include "subsystem.h"
+#include "timer_wheel.h"
+
+// Runs callbacks after a delay or on a repeating interval, measured in scaled game time
+// Timers wait in a hierarchical timer wheel so only timers that come due cost anything each frame
+class TimerSubsystem final : public Subsystem
+{
+	DECLARE_SUBSYSTEM(TimerSubsystem)
+
+public:
+	using Callback = std::function<void()>;
+
+	// Duration of a timer wheel tick in seconds
+	static constexpr double resolution = 0.001;
+
+	TimerSubsystem();
+
+	// ----------- Engine API -----------
+	void start() override;
+	void shutdown() override;
+	void tick(float delta_time) override;
+	// ----------------------------------
+
+	// ------------ User API ------------
+
+	// Invokes the callback once after the given number of seconds
+	TimerHandle after(float seconds, Callback&& callback);
+
+	// Invokes the callback every interval until cancelled
+	TimerHandle every(float interval, Callback&& callback);
+
+	// Returns false if the timer had already finished or been cancelled
+	bool cancel(TimerHandle handle);
+
+	[[nodiscard]] bool pending(TimerHandle handle) const noexcept;
+	[[nodiscard]] size_t num_timers() const noexcept { return _timers.num_timers(); }
+	// ----------------------------------
+
+private:
+	// Number of wheel ticks from now until the given number of seconds have passed
+	[[nodiscard]] uint64_t ticks_until(float seconds) const noexcept;
+
+	TimerWheel _timers;
+	double _time;
+};
@@ -0,0 +1,228 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+#include <utils/check.h>
+
+TimerWheel::TimerWheel()
+	: _current_tick(0)
+	, _num_timers(0)
+	, _firing(null_index)
+	, _firing_cancelled(false)
+{
+	_slots.fill(null_index);
+}
+
+TimerWheel::Handle TimerWheel::schedule(uint64_t delay, Callback&& callback, uint64_t interval)
+{
+	check(callback);
+
+	uint32_t index;
+	if (!_free_indices.empty())
+	{
+		index = _free_indices.back();
+		_free_indices.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(_timers.size());
+		_timers.emplace_back();
+	}
+
+	Timer& timer = _timers[index];
+	timer.expiry = _current_tick + std::max<uint64_t>(delay, 1);
+	timer.interval = interval;
+	timer.callback = std::move(callback);
+
+	insert(index);
+	_num_timers++;
+
+	return Handle{
+		.index = index,
+		.generation = timer.generation
+	};
+}
+
+bool TimerWheel::cancel(Handle handle)
+{
+	if (!pending(handle))
+	{
+		return false;
+	}
+
+	if (handle.index == _firing)
+	{
+		// Released once the callback returns, as the callback is still executing
+		_firing_cancelled = true;
+		return true;
+	}
+
+	unlink(handle.index);
+	release(handle.index);
+
+	return true;
+}
+
+bool TimerWheel::pending(Handle handle) const noexcept
+{
+	if (handle.index >= _timers.size())
+	{
+		return false;
+	}
+
+	const Timer& timer = _timers[handle.index];
+	if (timer.generation != handle.generation)
+	{
+		return false;
+	}
+
+	return handle.index != _firing || !_firing_cancelled;
+}
+
+void TimerWheel::advance_to(uint64_t tick)
+{
+	while (_current_tick < tick)
+	{
+		// Nothing can come due so the wheel can skip straight to the end
+		if (_num_timers == 0)
+		{
+			_current_tick = tick;
+			return;
+		}
+
+		_current_tick++;
+
+		// Each time a level wraps around, the next slot of the level above is redistributed into it
+		// Higher levels are cascaded first so that their timers can continue down to the lowest level
+		uint32_t top_level = 0;
+		while (top_level + 1 < num_levels && (_current_tick & ((uint64_t(1) << (slot_bits * (top_level + 1))) - 1)) == 0)
+		{
+			top_level++;
+		}
+
+		for (uint32_t level = top_level; level > 0; level--)
+		{
+			cascade(level);
+		}
+
+		fire_slot(static_cast<uint32_t>(_current_tick & (slots_per_level - 1)));
+	}
+}
+
+void TimerWheel::clear()
+{
+	check(_firing == null_index);
+
+	_timers.clear();
+	_free_indices.clear();
+	_slots.fill(null_index);
+	_num_timers = 0;
+}
+
+void TimerWheel::insert(uint32_t index)
+{
+	Timer& timer = _timers[index];
+
+	const uint64_t delay = timer.expiry > _current_tick ? timer.expiry - _current_tick : 0;
+	const uint64_t expiry = _current_tick + std::min(delay, max_delay);
+
+	uint32_t level = 0;
+	while (level + 1 < num_levels && delay >= uint64_t(1) << (slot_bits * (level + 1)))
+	{
+		level++;
+	}
+
+	const uint32_t slot = level * slots_per_level + static_cast<uint32_t>((expiry >> (slot_bits * level)) & (slots_per_level - 1));
+
+	timer.slot = slot;
+	timer.prev = null_index;
+	timer.next = _slots[slot];
+
+	if (timer.next != null_index)
+	{
+		_timers[timer.next].prev = index;
+	}
+
+	_slots[slot] = index;
+}
+
+void TimerWheel::unlink(uint32_t index)
+{
+	Timer& timer = _timers[index];
+	check(timer.slot != null_index);
+
+	if (timer.prev != null_index)
+	{
+		_timers[timer.prev].next = timer.next;
+	}
+	else
+	{
+		_slots[timer.slot] = timer.next;
+	}
+
+	if (timer.next != null_index)
+	{
+		_timers[timer.next].prev = timer.prev;
+	}
+
+	timer.prev = null_index;
+	timer.next = null_index;
+	timer.slot = null_index;
+}
+
+void TimerWheel::release(uint32_t index)
+{
+	Timer& timer = _timers[index];
+	timer.callback = nullptr;
+	timer.generation++;
+
+	_free_indices.push_back(index);
+	_num_timers--;
+}
+
+void TimerWheel::cascade(uint32_t level)
+{
+	const uint32_t slot = level * slots_per_level + static_cast<uint32_t>((_current_tick >> (slot_bits * level)) & (slots_per_level - 1));
+
+	uint32_t index = _slots[slot];
+	_slots[slot] = null_index;
+
+	while (index != null_index)
+	{
+		const uint32_t next = _timers[index].next;
+		insert(index);
+		index = next;
+	}
+}
+
+void TimerWheel::fire_slot(uint32_t slot)
+{
+	// Timers are unlinked one at a time as callbacks may cancel others in the same slot
+	while (_slots[slot] != null_index)
+	{
+		const uint32_t index = _slots[slot];
+		unlink(index);
+
+		// The callback is moved out as scheduling from within it may reallocate the timers
+		Callback callback = std::move(_timers[index].callback);
+
+		_firing = index;
+		_firing_cancelled = false;
+
+		callback();
+
+		_firing = null_index;
+
+		Timer& timer = _timers[index];
+		if (timer.interval > 0 && !_firing_cancelled)
+		{
+			timer.expiry = _current_tick + timer.interval;
+			timer.callback = std::move(callback);
+			insert(index);
+		}
+		else
+		{
+			release(index);
+		}
+	}
+}
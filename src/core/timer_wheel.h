@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+// Hierarchical timing wheel that schedules callbacks a whole number of ticks into the future
+// Scheduling and cancelling are O(1), and advancing only touches slots that come due
+// Timers far in the future sit in coarser wheels and cascade down into finer ones as they approach
+class TimerWheel
+{
+public:
+	using Callback = std::function<void()>;
+
+	static constexpr uint32_t slot_bits = 8;
+	static constexpr uint32_t slots_per_level = 1 << slot_bits;
+	static constexpr uint32_t num_levels = 4;
+
+	// Furthest ahead a timer can be placed directly, anything later waits in the last level and cascades again
+	static constexpr uint64_t max_delay = (uint64_t(1) << (slot_bits * num_levels)) - 1;
+
+	struct Handle
+	{
+		uint32_t index = UINT32_MAX;
+		uint32_t generation = 0;
+
+		[[nodiscard]] bool operator==(const Handle& other) const = default;
+	};
+
+	TimerWheel();
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel(TimerWheel&&) = delete;
+
+	// Invokes the callback once the wheel has advanced the given number of ticks, delays are at least 1 tick
+	// Repeating timers are rescheduled by their interval after each call until cancelled
+	Handle schedule(uint64_t delay, Callback&& callback, uint64_t interval = 0);
+
+	// Returns false if the timer had already fired or been cancelled
+	// A repeating timer may cancel itself from within its own callback
+	bool cancel(Handle handle);
+
+	[[nodiscard]] bool pending(Handle handle) const noexcept;
+
+	// Advances the wheel to the given tick, invoking every callback that comes due in order of expiry
+	// Callbacks may freely schedule and cancel other timers
+	void advance_to(uint64_t tick);
+
+	void clear();
+
+	[[nodiscard]] uint64_t current_tick() const noexcept { return _current_tick; }
+	[[nodiscard]] size_t num_timers() const noexcept { return _num_timers; }
+
+private:
+	static constexpr uint32_t null_index = UINT32_MAX;
+
+	struct Timer
+	{
+		uint64_t expiry = 0;
+		uint64_t interval = 0;
+		Callback callback;
+
+		uint32_t generation = 1;
+		uint32_t prev = null_index;
+		uint32_t next = null_index;
+
+		// Slot the timer is linked into, or null_index when it isn't waiting in the wheel
+		uint32_t slot = null_index;
+	};
+
+	void insert(uint32_t index);
+	void unlink(uint32_t index);
+	void release(uint32_t index);
+
+	void cascade(uint32_t level);
+	void fire_slot(uint32_t slot);
+
+	std::vector<Timer> _timers;
+	std::vector<uint32_t> _free_indices;
+	std::array<uint32_t, slots_per_level * num_levels> _slots;
+
+	uint64_t _current_tick;
+	size_t _num_timers;
+
+	// Timer whose callback is currently running, so that it can cancel itself
+	uint32_t _firing;
+	bool _firing_cancelled;
+};
+
+// Refers to a timer scheduled through the timer subsystem
+using TimerHandle = TimerWheel::Handle;
\ No newline at end of file
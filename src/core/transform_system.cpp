@@ -0,0 +1,212 @@
+#include "transform_system.h"
+
+#include <span>
+#include <algorithm>
+
+#include <profiling/scoped_event.h>
+#include <profiling/counter.h>
+#include <threading/job_system.h>
+
+#include "entity.h"
+
+void TransformSystem::mark_transform_dirty(EntityHandle<Entity> entity)
+{
+	_dirty_entities.push_back(entity);
+}
+
+void TransformSystem::update(const std::vector<peng::shared_ref<Entity>>& entities)
+{
+	if (!_hierarchy_dirty && _dirty_entities.empty())
+	{
+		return;
+	}
+
+	SCOPED_EVENT("TransformSystem - update");
+
+	if (_hierarchy_dirty)
+	{
+		rebuild(entities);
+		_hierarchy_dirty = false;
+
+		// Entities that were just added were never marked, so every node is visited
+		for (size_t level = 0; level < num_levels(); level++)
+		{
+			update_level(level);
+		}
+
+		SET_COUNTER("TransformSystem - hierarchy depth", num_levels());
+	}
+	else
+	{
+		update_dirty_subtrees();
+	}
+
+	_dirty_entities.clear();
+}
+
+void TransformSystem::clear()
+{
+	_nodes.clear();
+	_local_matrices.clear();
+	_world_matrices.clear();
+	_level_offsets.clear();
+	_dirty_entities.clear();
+	_hierarchy_dirty = true;
+}
+
+void TransformSystem::rebuild(const std::vector<peng::shared_ref<Entity>>& entities)
+{
+	SCOPED_EVENT("TransformSystem - rebuild hierarchy");
+
+	_nodes.clear();
+	_level_offsets.clear();
+
+	for (const peng::shared_ref<Entity>& entity : entities)
+	{
+		if (!entity->has_spatial_parent())
+		{
+			_nodes.push_back(Node{
+				.entity = entity.get(),
+				.parent = -1
+			});
+		}
+	}
+
+	// Breadth first so that each level only depends on the one before it
+	size_t level_begin = 0;
+	while (level_begin < _nodes.size())
+	{
+		const size_t level_end = _nodes.size();
+		_level_offsets.push_back(level_begin);
+
+		for (size_t node_index = level_begin; node_index < level_end; node_index++)
+		{
+			for (const EntityHandle<Entity>& child : _nodes[node_index].entity->children())
+			{
+				if (Entity* child_entity = child.get(); child_entity && child_entity->has_spatial_parent())
+				{
+					_nodes.push_back(Node{
+						.entity = child_entity,
+						.parent = static_cast<int32_t>(node_index)
+					});
+				}
+			}
+		}
+
+		level_begin = level_end;
+	}
+
+	_level_offsets.push_back(_nodes.size());
+
+	_local_matrices.resize(_nodes.size());
+	_world_matrices.resize(_nodes.size());
+}
+
+void TransformSystem::update_level(size_t level)
+{
+	const size_t begin = _level_offsets[level];
+	const size_t end = _level_offsets[level + 1];
+
+	auto update = [this](const Node& node)
+	{
+		update_node(&node - _nodes.data());
+	};
+
+	if (end - begin >= parallel_threshold)
+	{
+		threading::JobSystem::get().parallel_for(std::span(_nodes).subspan(begin, end - begin), parallel_batch_size, update);
+	}
+	else
+	{
+		std::for_each(_nodes.begin() + begin, _nodes.begin() + end, update);
+	}
+}
+
+void TransformSystem::update_node(size_t node_index)
+{
+	const Node& node = _nodes[node_index];
+	Entity& entity = *node.entity;
+
+	// A valid cache implies that the caches of all spatial parents are valid too,
+	// so the matrix only needs copying across for any children that still need rebuilding
+	if (entity._world_matrix_valid)
+	{
+		_world_matrices[node_index] = entity._world_matrix;
+		return;
+	}
+
+	math::Matrix4x4f& local_matrix = _local_matrices[node_index];
+	math::Matrix4x4f& world_matrix = _world_matrices[node_index];
+
+	local_matrix = entity._local_transform.to_matrix();
+	world_matrix = node.parent >= 0
+		? math::multiply(_world_matrices[node.parent], local_matrix)
+		: local_matrix;
+
+	entity._world_matrix = world_matrix;
+	entity._world_matrix_valid = true;
+}
+
+
+void TransformSystem::update_dirty_subtrees()
+{
+	_dirty_roots.clear();
+
+	for (const EntityHandle<Entity>& handle : _dirty_entities)
+	{
+		// Skips entities that have since been killed or lazily rebuilt, and entities within the subtree of
+		// another dirty entity. A valid cache implies a valid parent cache, so the remaining roots never overlap
+		Entity* entity = handle.get();
+		if (!entity || entity->_world_matrix_valid)
+		{
+			continue;
+		}
+
+		if (entity->has_spatial_parent() && !entity->_parent->_world_matrix_valid)
+		{
+			continue;
+		}
+
+		_dirty_roots.push_back(entity);
+	}
+
+	// An entity is marked again if it was lazily rebuilt and then invalidated a second time
+	std::ranges::sort(_dirty_roots);
+	const auto duplicates = std::ranges::unique(_dirty_roots);
+	_dirty_roots.erase(duplicates.begin(), duplicates.end());
+
+	SET_COUNTER("TransformSystem - dirty roots", _dirty_roots.size());
+
+	auto update = [](Entity* entity)
+	{
+		update_subtree(*entity);
+	};
+
+	if (_dirty_roots.size() >= parallel_threshold)
+	{
+		threading::JobSystem::get().parallel_for(_dirty_roots, parallel_batch_size, update);
+	}
+	else
+	{
+		std::ranges::for_each(_dirty_roots, update);
+	}
+}
+
+void TransformSystem::update_subtree(Entity& entity)
+{
+	const math::Matrix4x4f local_matrix = entity._local_transform.to_matrix();
+	entity._world_matrix = entity.has_spatial_parent()
+		? math::multiply(entity._parent->_world_matrix, local_matrix)
+		: local_matrix;
+
+	entity._world_matrix_valid = true;
+
+	// Every spatial child of an invalid entity is invalid as well
+	for (const EntityHandle<Entity>& child : entity._children)
+	{
+		if (Entity* child_entity = child.get(); child_entity && child_entity->has_spatial_parent())
+		{
+			update_subtree(*child_entity);
+		}
+	}
+}
\ No newline at end of file
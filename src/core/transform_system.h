@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <memory/shared_ref.h>
+#include <math/matrix4x4.h>
+
+#include "entity_handle.h"
+
+class Entity;
+
+// Keeps the spatial hierarchy flattened into arrays sorted by depth so that parents always precede their children
+// After the hierarchy changes, world matrices are rebuilt one level at a time, with each level processed
+// in parallel once it is large enough. Otherwise only the subtrees of entities that moved are rebuilt
+class TransformSystem
+{
+public:
+	// Levels with fewer nodes than this are updated serially as dispatch would cost more than it saves
+	static constexpr size_t parallel_threshold = 256;
+	static constexpr size_t parallel_batch_size = 64;
+
+	TransformSystem() = default;
+	TransformSystem(const TransformSystem&) = delete;
+	TransformSystem(TransformSystem&&) = delete;
+
+	// Must be called whenever an entity is added, removed or reparented
+	void mark_hierarchy_dirty() noexcept { _hierarchy_dirty = true; }
+
+	// Must be called whenever the cached world matrix of an entity is invalidated
+	// Only the entity the invalidation started from needs marking, its children are rebuilt along with it
+	void mark_transform_dirty(EntityHandle<Entity> entity);
+
+	// Rebuilds the world matrix of every entity whose cached matrix has been invalidated
+	// Returns immediately if nothing has changed since the last update
+	// Must be called from the main thread while no ticks are running
+	void update(const std::vector<peng::shared_ref<Entity>>& entities);
+
+	void clear();
+
+	[[nodiscard]] size_t num_nodes() const noexcept { return _nodes.size(); }
+	[[nodiscard]] size_t num_levels() const noexcept { return _level_offsets.empty() ? 0 : _level_offsets.size() - 1; }
+
+private:
+	struct Node
+	{
+		Entity* entity;
+
+		// Index of the spatial parent within the flattened arrays, or -1 for roots
+		int32_t parent;
+	};
+
+	void rebuild(const std::vector<peng::shared_ref<Entity>>& entities);
+	void update_level(size_t level);
+	void update_node(size_t node_index);
+
+	void update_dirty_subtrees();
+	static void update_subtree(Entity& entity);
+
+	std::vector<Node> _nodes;
+	std::vector<math::Matrix4x4f> _local_matrices;
+	std::vector<math::Matrix4x4f> _world_matrices;
+
+	// Level n spans [_level_offsets[n], _level_offsets[n + 1]) of the flattened arrays
+	std::vector<size_t> _level_offsets;
+	bool _hierarchy_dirty = true;
+
+	// Entities whose world matrix was invalidated since the last update, along with their subtrees
+	std::vector<EntityHandle<Entity>> _dirty_entities;
+	std::vector<Entity*> _dirty_roots;
+};
@@ -10,6 +10,14 @@ using namespace demo;
 using namespace input;
 using namespace rendering;
 
+void DebugEntity::post_create()
+{
+	Entity::post_create();
+
+	// Debug hotkeys can wait until the rest of the group has ticked
+	set_tick_priority(TickPriority::low);
+}
+
 void DebugEntity::tick(float delta_time)
 {
 	Entity::tick(delta_time);
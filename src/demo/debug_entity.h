@@ -10,7 +10,8 @@ namespace demo
 
 	public:
 		using Entity::Entity;
-		
+
+		void post_create() override;
 		void tick(float delta_time) override;
 	};
 }
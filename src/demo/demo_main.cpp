@@ -2,15 +2,20 @@
 
 #include <core/peng_engine.h>
 #include <core/asset.h>
+#include <core/entity_subsystem.h>
 #include <profiling/profiler_manager.h>
 #include <scene/scene_loader.h>
 #include <input/input_subsystem.h>
 #include <rendering/window_subsystem.h>
 #include <rendering/window_icon.h>
 #include <entities/debug/bootloader.h>
+#include <entities/debug/engine_checks.h>
+
+#include "pong/pong_checks.h"
 
 #ifndef NO_PROFILING
 #include <profiling/superluminal_profiler.h>
+#include <profiling/alloc_tracker.h>
 #endif
 
 namespace demo
@@ -26,16 +31,43 @@ namespace demo
             Asset<rendering::WindowIcon> icon("resources/textures/core/peng_engine_64.asset");
             icon.load()->use();
 
+            // Low priority tickables get a millisecond each standard tick, any that don't fit resume on the next one
+            EntitySubsystem::get().set_tick_budget(TickGroup::standard, 1.0f);
+
             scene::SceneLoader scene_loader;
             scene_loader.load_from_file("resources/scenes/demo/pong.json");
         });
 
 #ifndef PENG_MASTER
+        pong::PongChecks::add_checks();
+
         PengEngine::get().on_frame_start().subscribe([] {
             if (input::InputSubsystem::get()[input::KeyCode::f2].pressed())
             {
                 entities::debug::Bootloader::initiate();
             }
+
+            if (input::InputSubsystem::get()[input::KeyCode::f3].pressed())
+            {
+                EntitySubsystem::get().benchmark_teardown(100000);
+                entities::debug::Bootloader::initiate();
+            }
+
+            if (input::InputSubsystem::get()[input::KeyCode::f5].pressed())
+            {
+                entities::debug::EngineChecks::run_all();
+                entities::debug::Bootloader::initiate();
+            }
+
+#ifndef NO_PROFILING
+            // Zero allocation verification, any steady state frame that allocates fails the run
+            if (input::InputSubsystem::get()[input::KeyCode::f4].pressed())
+            {
+                profiling::AllocTracker& tracker = profiling::AllocTracker::get();
+                tracker.set_frame_budget(0, 60);
+                tracker.set_enabled(!tracker.enabled());
+            }
+#endif
         });
 #endif
         
@@ -44,6 +76,13 @@ namespace demo
         PengEngine::get().set_target_frametime(0);
         PengEngine::get().run();
 
+#ifndef NO_PROFILING
+        if (profiling::AllocTracker::get().frames_over_budget() > 0)
+        {
+            return 1;
+        }
+#endif
+
         return 0;
     }
 }
\ No newline at end of file
@@ -1,7 +1,6 @@
 #include "gravity_controller.h"
 
 #include <algorithm>
-#include <execution>
 
 #include <core/peng_engine.h>
 #include <profiling/scoped_event.h>
@@ -11,6 +10,7 @@
 #include <rendering/primitives.h>
 #include <rendering/window_subsystem.h>
 #include <math/math.h>
+#include <threading/job_system.h>
 
 IMPLEMENT_ENTITY(demo::gravity::GravityController);
 
@@ -27,9 +27,16 @@ void GravityController::post_create()
 	PengEngine::get().set_max_delta_time(50.0);
 	WindowSubsystem::get().set_window_name("PengEngine - Gravity Demo");
 
+	// Lots of identical rocks, so benefits from having their components grouped
+	EntitySubsystem::get().set_storage_mode(EntityStorageMode::archetype);
+
 	create_rock_field(500, 5, 2);
 	create_rock_field(100, 10, 4);
 
+	// Attraction is quadratic in the number of rocks and changes slowly, so it's applied every other tick
+	// over the time since it was last applied
+	set_tick_rate(TickRate{ .interval_ticks = 2 });
+
 	peng::shared_ref<const Texture> skybox_texture = peng::make_shared<Texture>("skybox",
 		"resources/textures/demo/skybox.jpg"
 	);
@@ -45,26 +52,13 @@ void GravityController::tick(float delta_time)
 	SCOPED_EVENT("GravityController - tick");
 	Entity::tick(delta_time);
 
-	// Accessing via weak-ptr is quite slow due to thread safety so cache raw ptrs
-	std::vector<Rock*> rock_ptrs;
-
-	{
-		SCOPED_EVENT("GravityController - cache pointers");
-
-		rock_ptrs.reserve(_rocks.size());
-		for (auto& rock : _rocks)
-		{
-			rock_ptrs.push_back(rock.lock().get());
-		}
-	}
-
 	{
 		SCOPED_EVENT("GravityController - apply attraction");
 
-		std::for_each(
-			std::execution::par_unseq, rock_ptrs.begin(), rock_ptrs.end(),
-			[&](Rock* rock1) {
-				for (Rock* rock2 : rock_ptrs)
+		threading::JobSystem::get().parallel_for(
+			_rocks, 16,
+			[&](const EntityHandle<Rock>& rock1) {
+				for (const EntityHandle<Rock>& rock2 : _rocks)
 				{
 					if (rock1 != rock2)
 					{
@@ -19,6 +19,6 @@ namespace demo::gravity
 	private:
 		void create_rock_field(int32_t count, float radius, float speed);
 
-		std::vector<peng::weak_ptr<Rock>> _rocks;
+		std::vector<EntityHandle<Rock>> _rocks;
 	};
 }
@@ -26,8 +26,8 @@ void Rock::tick(float delta_time)
 
 	_radius = std::powf(mass, 0.33f) * scale;
 
-	_local_transform.scale = math::Vector3f::one() * _radius;
-	_local_transform.position += velocity * delta_time;
+	local_transform().scale = math::Vector3f::one() * _radius;
+	local_transform().position += velocity * delta_time;
 }
 
 float Rock::radius() const noexcept
@@ -11,6 +11,12 @@ namespace demo::gravity
 	public:
 		using Entity::Entity;
 
+		// Instances don't tick concurrently with each other since moving a rock invalidates its children
+		static constexpr TickAccess tick_access = {
+			.reads = DataDomain::physics,
+			.writes = DataDomain::transforms
+		};
+
 		void post_create() override;
 		void tick(float delta_time) override;
 
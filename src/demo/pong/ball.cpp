@@ -39,7 +39,7 @@ Ball::Ball()
 			handle_collision(collider);
 		});
 
-	_local_transform.scale = Vector3f(1, 1, 1);
+	local_transform().scale = Vector3f(1, 1, 1);
 	respawn();
 }
 
@@ -51,7 +51,7 @@ void Ball::respawn()
 	const Vector2f velocity = dir * reflector * _speed * 0.75f;
 
 	get_component<RigidBody2D>()->velocity = velocity;
-	_local_transform.position = Vector3f::zero();
+	local_transform().position = Vector3f::zero();
 }
 
 void Ball::handle_collision(peng::weak_ptr<Collider2D> collider)
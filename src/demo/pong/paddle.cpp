@@ -27,7 +27,7 @@ Paddle::Paddle(const std::string& name)
 			handle_collision(other);
 		});
 
-	_local_transform.scale = Vector3f(1, 7, 1);
+	local_transform().scale = Vector3f(1, 7, 1);
 }
 
 void Paddle::tick(float delta_time)
@@ -54,7 +54,7 @@ void Paddle::handle_collision(peng::weak_ptr<Collider2D> collider)
 		const Vector3f dist = other_aabb.center - aabb.center;
 		const Vector3f desired_dist = other_aabb.size + aabb.size;
 
-		_local_transform.position.y = (other_aabb.center - desired_dist * sgn(dist.y)).y;
+		local_transform().position.y = (other_aabb.center - desired_dist * sgn(dist.y)).y;
 		get_component<RigidBody2D>()->velocity = Vector2f::zero();
 	}
 }
@@ -4,20 +4,22 @@
 #include <components/text_renderer.h>
 #include <input/input_subsystem.h>
 
+IMPLEMENT_ENTITY(demo::pong::PauseMenu);
+
 using namespace demo::pong;
 using namespace components;
 using namespace input;
 using namespace math;
 
 PauseMenu::PauseMenu()
-    : Entity("PauseMenu")
+    : Entity("PauseMenu", TickGroup::none)
 { }
 
 void PauseMenu::post_create()
 {
     Entity::post_create();
 
-    _local_transform.position = Vector3f(0, 0, -5);
+    local_transform().position = Vector3f(0, 0, -5);
 
 	peng::weak_ptr<Entity> background = create_child<Entity>("Background");
 	background->local_transform().position = Vector3f(0, 0, 1);
@@ -51,42 +53,7 @@ void PauseMenu::post_create()
     }
 
     update_buttons();
-}
-
-void PauseMenu::tick(float delta_time)
-{
-    Entity::tick(delta_time);
-
-    const int32_t num_entries = static_cast<int32_t>(_buttons.size());
-    if (num_entries == 0)
-    {
-        return;
-    }
-
-    int32_t new_selection = _selected_entry;
-
-    if (InputSubsystem::get()[KeyCode::down].pressed())
-    {
-        new_selection = ++new_selection % num_entries;
-    }
-
-    if (InputSubsystem::get()[KeyCode::up].pressed())
-    {
-        new_selection = (--new_selection + num_entries) % num_entries;
-    }
-
-    if (new_selection != _selected_entry)
-    {
-        _selected_entry = new_selection;
-        update_buttons();
-        _on_selection_change();
-    }
-
-    if (InputSubsystem::get()[KeyCode::enter].pressed())
-    {
-        _on_selection_click();
-        _button_events[_selected_entry]->invoke();
-    }
+    start_behavior(handle_input());
 }
 
 void PauseMenu::show()
@@ -102,6 +69,46 @@ void PauseMenu::hide()
     set_active(false);
 }
 
+Behavior PauseMenu::handle_input()
+{
+    const int32_t num_entries = static_cast<int32_t>(_buttons.size());
+    if (num_entries == 0)
+    {
+        co_return;
+    }
+
+    // Only resumes while the menu is shown
+    for (;;)
+    {
+        co_await next_frame();
+
+        int32_t new_selection = _selected_entry;
+
+        if (InputSubsystem::get()[KeyCode::down].pressed())
+        {
+            new_selection = ++new_selection % num_entries;
+        }
+
+        if (InputSubsystem::get()[KeyCode::up].pressed())
+        {
+            new_selection = (--new_selection + num_entries) % num_entries;
+        }
+
+        if (new_selection != _selected_entry)
+        {
+            _selected_entry = new_selection;
+            update_buttons();
+            _on_selection_change();
+        }
+
+        if (InputSubsystem::get()[KeyCode::enter].pressed())
+        {
+            _on_selection_click();
+            _button_events[_selected_entry]->invoke();
+        }
+    }
+}
+
 void PauseMenu::update_buttons()
 {
     for (int32_t i = 0; i < _buttons.size(); i++)
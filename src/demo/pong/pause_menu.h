@@ -19,7 +19,6 @@ namespace demo::pong
 		PauseMenu();
 
 		void post_create() override;
-		void tick(float delta_time) override;
 
 		void show();
 		void hide();
@@ -28,6 +27,7 @@ namespace demo::pong
 		float btn_size = 1;
 
 	private:
+		Behavior handle_input();
 		void update_buttons();
 
 		int32_t _selected_entry = 0;
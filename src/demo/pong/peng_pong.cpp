@@ -1,6 +1,7 @@
 #include "peng_pong.h"
 
 #include <core/asset.h>
+#include <core/prefab.h>
 #include <core/serialized_member.h>
 #include <core/logger.h>
 #include <core/peng_engine.h>
@@ -123,9 +124,8 @@ void PengPong::build_world()
 	const float ortho_width = ortho_size * WindowSubsystem::get().aspect_ratio();
 	const float paddle_delta_x = ortho_width - paddle_margin;
 
-	peng::weak_ptr<Entity> ball = _world_root->load_child(
-		Archive::from_disk("resources/entities/demo/pong/ball.asset")
-	);
+	peng::weak_ptr<Entity> ball = Asset<Prefab>("resources/entities/demo/pong/ball.asset").load()->instantiate();
+	_world_root->add_child(ball);
 
 	peng::weak_ptr<Paddle> paddle_1 = _world_root->create_child<Paddle>("Paddle1");
 	paddle_1->input_axis.positive = KeyCode::w;
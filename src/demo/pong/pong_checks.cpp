@@ -0,0 +1,55 @@
+#include "pong_checks.h"
+
+#include <core/entity_subsystem.h>
+#include <entities/debug/engine_checks.h>
+
+#include "ball.h"
+#include "pause_menu.h"
+
+using namespace demo::pong;
+using namespace entities::debug;
+
+namespace
+{
+	// Clones the entity once it has been created, and compares the copy against the original once it has been created too
+	bool check_clone_counts(const char* check_name, const peng::weak_ptr<Entity>& original)
+	{
+		EngineChecks::tick_world();
+
+		const peng::weak_ptr<Entity> copy = original->clone();
+		if (!EngineChecks::expect(copy.valid(), check_name, "the entity should be cloned"))
+		{
+			return false;
+		}
+
+		EngineChecks::tick_world();
+
+		bool passed = EngineChecks::expect(
+			copy->components().size() == original->components().size(),
+			check_name, "the copy should have as many components as the original"
+		);
+
+		passed &= EngineChecks::expect(
+			copy->children().size() == original->children().size(),
+			check_name, "the copy should have as many children as the original"
+		);
+
+		return passed;
+	}
+}
+
+void PongChecks::add_checks()
+{
+	EngineChecks::add_check({ "clone ball", &check_clone_ball });
+	EngineChecks::add_check({ "clone pause menu", &check_clone_pause_menu });
+}
+
+bool PongChecks::check_clone_ball()
+{
+	return check_clone_counts("clone ball", EntitySubsystem::get().create_entity<Ball>());
+}
+
+bool PongChecks::check_clone_pause_menu()
+{
+	return check_clone_counts("clone pause menu", EntitySubsystem::get().create_entity<PauseMenu>());
+}
\ No newline at end of file
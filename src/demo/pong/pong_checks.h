@@ -0,0 +1,16 @@
+#pragma once
+
+namespace demo::pong
+{
+	// Engine checks that need the pong entities, see entities::debug::EngineChecks
+	class PongChecks
+	{
+	public:
+		static void add_checks();
+
+	private:
+		// Cloning must not duplicate the components and children an entity creates for itself
+		static bool check_clone_ball();
+		static bool check_clone_pause_menu();
+	};
+}
\ No newline at end of file
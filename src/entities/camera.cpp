@@ -1,6 +1,7 @@
 #include "camera.h"
 
 #include <numbers>
+#include <utility>
 
 #include <core/logger.h>
 #include <core/serialized_member.h>
@@ -13,7 +14,7 @@ using namespace entities;
 using namespace rendering;
 using namespace math;
 
-peng::weak_ptr<Camera> Camera::_current;
+EntityHandle<Camera> Camera::_current;
 
 Camera::Camera()
 	: Camera("Camera")
@@ -42,7 +43,7 @@ Camera::Camera(std::string&& name)
 	SERIALIZED_MEMBER(_projection);
 }
 
-const peng::weak_ptr<Camera>& Camera::current()
+const EntityHandle<Camera>& Camera::current()
 {
 	return _current;
 }
@@ -56,7 +57,7 @@ void Camera::post_create()
 		Logger::warning("Camera entity created when a valid camera already exists");
 	}
 
-	_current = weak_this();
+	_current = handle_this();
 	check(_current);
 }
 
@@ -159,7 +160,8 @@ Matrix4x4f Camera::calc_projection_matrix()
 		ortho_transform.position = Vector3f(0, 0, _near_clip);
 		ortho_transform.scale = Vector3f(effective_ortho_size * aspect_ratio, effective_ortho_size, _far_clip - _near_clip);
 
-		Vector3f& scale = _local_transform.scale;
+		// Only take mutable access when fixing the scale so the cached world matrix isn't invalidated every frame
+		const Vector3f& scale = std::as_const(*this).local_transform().scale;
 		if (scale.x * scale.y * scale.z == 0.0f)
 		{
 			Logger::warning(
@@ -167,7 +169,7 @@ Matrix4x4f Camera::calc_projection_matrix()
 				scale.x, scale.y, scale.z
 			);
 
-			scale = Vector3f::one();
+			local_transform().scale = Vector3f::one();
 		}
 
 		return ortho_transform.to_inverse_matrix();
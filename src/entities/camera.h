@@ -28,7 +28,7 @@ namespace entities
 		explicit Camera(const std::string& name);
 		explicit Camera(std::string&& name);
 
-		static const peng::weak_ptr<Camera>& current();
+		static const EntityHandle<Camera>& current();
 
 		void post_create() override;
 		void tick(float delta_time) override;
@@ -48,7 +48,7 @@ namespace entities
 		[[nodiscard]] Projection projection() const noexcept;
 
 	private:
-		static peng::weak_ptr<Camera> _current;
+		static EntityHandle<Camera> _current;
 
 		void validate_config() const noexcept;
 		[[nodiscard]] math::Matrix4x4f calc_projection_matrix();
@@ -19,11 +19,7 @@ Bootloader::Bootloader()
 
 void Bootloader::initiate()
 {
-    for (const peng::weak_ptr<Entity>& entity : EntitySubsystem::get().all_entities())
-    {
-        entity->destroy();
-    }
-
+    EntitySubsystem::get().clear_world();
     EntitySubsystem::get().create_entity<Bootloader>();
 }
 
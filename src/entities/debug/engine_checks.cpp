@@ -0,0 +1,308 @@
+#include "engine_checks.h"
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <core/entity.h>
+#include <core/component.h>
+#include <core/entity_subsystem.h>
+#include <core/logger.h>
+
+namespace entities::debug
+{
+	// Appends itself to the tick log whenever it ticks
+	class CheckTickRecorder : public Component
+	{
+		DECLARE_COMPONENT(CheckTickRecorder);
+
+	public:
+		static std::vector<const Component*> tick_log;
+
+		void tick(float delta_time) override
+		{
+			Component::tick(delta_time);
+			tick_log.push_back(this);
+		}
+	};
+
+	class CheckTickRecorderAlt final : public CheckTickRecorder
+	{
+		DECLARE_COMPONENT(CheckTickRecorderAlt);
+	};
+
+	// Adds a tick recorder to its owner while ticking concurrently and looks it up straight away
+	class CheckRecordedAdder final : public Component
+	{
+		DECLARE_COMPONENT(CheckRecordedAdder);
+
+	public:
+		static bool recording;
+		static bool found;
+		static bool required_same;
+
+		CheckRecordedAdder()
+			: Component(TickGroup::render_parallel)
+		{ }
+
+		void tick(float delta_time) override
+		{
+			Component::tick(delta_time);
+
+			recording = EntitySubsystem::get().recording_commands();
+
+			const peng::weak_ptr<CheckTickRecorder> added = owner().add_component<CheckTickRecorder>();
+			found = owner().has_component<CheckTickRecorder>() && owner().get_component<CheckTickRecorder>() == added;
+			required_same = owner().require_component<CheckTickRecorder>() == added;
+		}
+	};
+
+	std::vector<const Component*> CheckTickRecorder::tick_log;
+
+	bool CheckRecordedAdder::recording = false;
+	bool CheckRecordedAdder::found = false;
+	bool CheckRecordedAdder::required_same = false;
+}
+
+IMPLEMENT_COMPONENT(entities::debug::CheckTickRecorder);
+IMPLEMENT_COMPONENT(entities::debug::CheckTickRecorderAlt);
+IMPLEMENT_COMPONENT(entities::debug::CheckRecordedAdder);
+
+using namespace entities::debug;
+
+int32_t EngineChecks::run_all()
+{
+	std::vector<Check> checks = {
+		{ "archetype tick order", &check_archetype_tick_order },
+		{ "recorded component lookup", &check_recorded_component_lookup },
+		{ "tick scheduling", &check_tick_scheduling },
+	};
+
+	checks.insert(checks.end(), added_checks().begin(), added_checks().end());
+
+	int32_t num_failed = 0;
+	for (const Check& check : checks)
+	{
+		EntitySubsystem::get().clear_world();
+
+		if (check.run())
+		{
+			Logger::success("Engine check passed: %s", check.name);
+		}
+		else
+		{
+			Logger::error("Engine check failed: %s", check.name);
+			num_failed++;
+		}
+	}
+
+	EntitySubsystem::get().clear_world();
+	return num_failed;
+}
+
+void EngineChecks::add_check(const Check& check)
+{
+	added_checks().push_back(check);
+}
+
+void EngineChecks::tick_world()
+{
+	EntitySubsystem::get().tick(1 / 60.0f);
+}
+
+bool EngineChecks::expect(bool condition, const char* check_name, const char* message)
+{
+	if (!condition)
+	{
+		Logger::error("%s: %s", check_name, message);
+	}
+
+	return condition;
+}
+
+std::vector<EngineChecks::Check>& EngineChecks::added_checks()
+{
+	static std::vector<Check> checks;
+	return checks;
+}
+
+bool EngineChecks::check_archetype_tick_order()
+{
+	constexpr const char* name = "archetype tick order";
+	constexpr int32_t num_entities = 8;
+
+	EntitySubsystem& entity_subsystem = EntitySubsystem::get();
+	const EntityStorageMode prev_storage_mode = entity_subsystem.storage_mode();
+	entity_subsystem.set_storage_mode(EntityStorageMode::archetype);
+
+	std::vector<peng::weak_ptr<Entity>> entities;
+	for (int32_t i = 0; i < num_entities; i++)
+	{
+		// Added in the opposite order on every other entity, which must still share one archetype
+		const peng::weak_ptr<Entity> entity = entity_subsystem.create_entity<Entity>("Tick Order Check", TickGroup::none);
+		if (i % 2 == 0)
+		{
+			entity->add_component<CheckTickRecorder>();
+			entity->add_component<CheckTickRecorderAlt>();
+		}
+		else
+		{
+			entity->add_component<CheckTickRecorderAlt>();
+			entity->add_component<CheckTickRecorder>();
+		}
+
+		entities.push_back(entity);
+	}
+
+	CheckTickRecorder::tick_log.clear();
+	tick_world();
+
+	const std::vector<const Component*> tick_log = std::move(CheckTickRecorder::tick_log);
+	bool passed = expect(tick_log.size() == static_cast<size_t>(num_entities) * 2, name, "every component should tick exactly once");
+	passed &= expect(entity_subsystem.archetype_storage().archetypes().size() == 1, name, "entities should share an archetype");
+
+	// Each entity's components must tick together before the next entity's
+	std::vector<const Entity*> owners;
+	for (const Component* component : tick_log)
+	{
+		const Entity* owner = &component->owner();
+		if (owners.empty() || owners.back() != owner)
+		{
+			passed &= expect(std::ranges::find(owners, owner) == owners.end(), name, "components of an entity should tick consecutively");
+			owners.push_back(owner);
+		}
+	}
+
+	for (const peng::weak_ptr<Entity>& entity : entities)
+	{
+		entity->destroy();
+	}
+
+	tick_world();
+	passed &= expect(entity_subsystem.archetype_storage().archetypes().empty(), name, "empty archetypes should be released");
+
+	entity_subsystem.set_storage_mode(prev_storage_mode);
+	return passed;
+}
+
+bool EngineChecks::check_recorded_component_lookup()
+{
+	constexpr const char* name = "recorded component lookup";
+
+	const peng::weak_ptr<Entity> entity = EntitySubsystem::get().create_entity<Entity>("Recorded Lookup Check", TickGroup::none);
+	entity->add_component<CheckRecordedAdder>();
+
+	CheckRecordedAdder::recording = false;
+	CheckRecordedAdder::found = false;
+	CheckRecordedAdder::required_same = false;
+
+	// Created by the flush at the start of the tick, then ticked concurrently within the same tick
+	// A second tick would attach the first recorder and change what the lookups return
+	tick_world();
+
+	bool passed = expect(CheckRecordedAdder::recording, name, "the component should tick while commands are recorded");
+	passed &= expect(CheckRecordedAdder::found, name, "a component added while recording should be found by the thread that added it");
+	passed &= expect(CheckRecordedAdder::required_same, name, "requiring a component added while recording should not add another");
+
+	entity->destroy();
+	tick_world();
+	CheckTickRecorder::tick_log.clear();
+
+	return passed;
+}
+
+bool EngineChecks::check_tick_scheduling()
+{
+	constexpr const char* name = "tick scheduling";
+	constexpr int32_t num_throttled = 4;
+	constexpr int32_t num_low_priority = 3;
+
+	EntitySubsystem& entity_subsystem = EntitySubsystem::get();
+	const EntityStorageMode prev_storage_mode = entity_subsystem.storage_mode();
+	const float prev_tick_budget = entity_subsystem.tick_budget(TickGroup::standard);
+
+	// A budget this small runs out after the first low priority tickable, the rest resume on later ticks
+	entity_subsystem.set_tick_budget(TickGroup::standard, 0.000001f);
+
+	bool passed = true;
+	for (const EntityStorageMode storage_mode : { EntityStorageMode::standard, EntityStorageMode::archetype })
+	{
+		entity_subsystem.clear_world();
+		entity_subsystem.set_storage_mode(storage_mode);
+
+		// Set before the entities are created, so archetype storage leaves the components to the tick registry
+		std::vector<const Component*> throttled;
+		for (int32_t i = 0; i < num_throttled; i++)
+		{
+			const peng::weak_ptr<Entity> entity = entity_subsystem.create_entity<Entity>("Tick Rate Check", TickGroup::none);
+			const peng::weak_ptr<CheckTickRecorder> recorder = entity->add_component<CheckTickRecorder>();
+			recorder->set_tick_rate(TickRate{ .interval_ticks = 2 });
+			throttled.push_back(recorder.lock().get());
+		}
+
+		std::vector<const Component*> low_priority;
+		for (int32_t i = 0; i < num_low_priority; i++)
+		{
+			const peng::weak_ptr<Entity> entity = entity_subsystem.create_entity<Entity>("Tick Priority Check", TickGroup::none);
+			const peng::weak_ptr<CheckTickRecorderAlt> recorder = entity->add_component<CheckTickRecorderAlt>();
+			recorder->set_tick_priority(TickPriority::low);
+			low_priority.push_back(recorder.lock().get());
+		}
+
+		const auto contains = [](const std::vector<const Component*>& tickables, const Component* component)
+		{
+			return std::ranges::find(tickables, component) != tickables.end();
+		};
+
+		std::vector<const Component*> throttled_ticks;
+		std::vector<const Component*> low_priority_ticks;
+		for (int32_t tick = 0; tick < num_low_priority; tick++)
+		{
+			CheckTickRecorder::tick_log.clear();
+			tick_world();
+
+			const std::vector<const Component*> tick_log = std::move(CheckTickRecorder::tick_log);
+			const auto first_low_priority = std::ranges::find_if(tick_log, [&](const Component* component)
+			{
+				return contains(low_priority, component);
+			});
+
+			passed &= expect(first_low_priority != tick_log.end(), name, "a low priority tickable should tick even once the budget has run out");
+			passed &= expect(std::all_of(first_low_priority, tick_log.end(), [&](const Component* component)
+			{
+				return contains(low_priority, component);
+			}), name, "low priority tickables should tick after the rest of the group");
+
+			// Every throttled tickable ticks exactly once over two ticks of the group
+			if (tick < 2)
+			{
+				const size_t num_throttled_ticks = throttled_ticks.size();
+				std::ranges::copy_if(tick_log, std::back_inserter(throttled_ticks), [&](const Component* component)
+				{
+					return contains(throttled, component);
+				});
+
+				passed &= expect(throttled_ticks.size() - num_throttled_ticks == static_cast<size_t>(num_throttled / 2), name, "throttled tickables should be staggered over the ticks of the group");
+			}
+
+			low_priority_ticks.insert(low_priority_ticks.end(), first_low_priority, tick_log.end());
+		}
+
+		for (const Component* component : throttled)
+		{
+			passed &= expect(std::ranges::count(throttled_ticks, component) == 1, name, "a tickable with an interval of 2 should tick once every 2 ticks");
+		}
+
+		for (const Component* component : low_priority)
+		{
+			passed &= expect(contains(low_priority_ticks, component), name, "low priority tickables should take turns when the budget runs out");
+		}
+	}
+
+	entity_subsystem.clear_world();
+	entity_subsystem.set_storage_mode(prev_storage_mode);
+	entity_subsystem.set_tick_budget(TickGroup::standard, prev_tick_budget);
+	CheckTickRecorder::tick_log.clear();
+
+	return passed;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace entities::debug
+{
+	// Runtime checks of engine behaviour that can only be verified against a live world
+	// Every check runs on a cleared world, so the world must be reloaded once they have run
+	class EngineChecks
+	{
+	public:
+		struct Check
+		{
+			const char* name;
+			bool (*run)();
+		};
+
+		// Runs every check and logs the outcome of each, returning the number of checks that failed
+		static int32_t run_all();
+
+		// Adds a check that runs after the engine's own, for modules whose types can't be checked from here
+		static void add_check(const Check& check);
+
+		// Ticks the world once, flushing any pending changes beforehand
+		static void tick_world();
+
+		// Logs the message against the check if the condition doesn't hold
+		static bool expect(bool condition, const char* check_name, const char* message);
+
+	private:
+		[[nodiscard]] static std::vector<Check>& added_checks();
+
+		static bool check_archetype_tick_order();
+		static bool check_recorded_component_lookup();
+		static bool check_tick_scheduling();
+	};
+}
\ No newline at end of file
@@ -54,6 +54,17 @@ void DirectionalLight::post_create()
 	check(_current);
 }
 
+void DirectionalLight::pre_destroy()
+{
+	Entity::pre_destroy();
+
+	// Otherwise the static reference keeps the light's pooled block alive until the pool is gone
+	if (_current == weak_this())
+	{
+		_current = {};
+	}
+}
+
 DirectionalLight::LightData& DirectionalLight::data() noexcept
 {
 	return _data;
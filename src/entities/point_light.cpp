@@ -1,7 +1,6 @@
 #include "point_light.h"
 
 #include <core/serialized_member.h>
-#include <utils/vectools.h>
 #include <utils/utils.h>
 
 IMPLEMENT_ENTITY(entities::PointLight);
@@ -16,8 +15,6 @@ namespace entities
 
 using namespace entities;
 
-std::vector<peng::weak_ptr<PointLight>> PointLight::_active_lights;
-
 PointLight::PointLight()
 	: PointLight("PointLight")
 { }
@@ -37,25 +34,6 @@ PointLight::PointLight(std::string&& name)
 	SERIALIZED_MEMBER(_data);
 }
 
-const std::vector<peng::weak_ptr<PointLight>>& PointLight::active_lights()
-{
-	return _active_lights;
-}
-
-void PointLight::post_create()
-{
-	Entity::post_create();
-
-	_active_lights.push_back(weak_this());
-}
-
-void PointLight::pre_destroy()
-{
-	Entity::pre_destroy();
-
-	vectools::remove(_active_lights, weak_this());
-}
-
 PointLight::LightData& PointLight::data() noexcept
 {
 	return _data;
@@ -21,7 +21,7 @@ void Skybox::tick(float delta_time)
 {
 	Entity::tick(delta_time);
 
-	peng::weak_ptr<Camera> camera = Camera::current();
+	const EntityHandle<Camera> camera = Camera::current();
 	if (!camera)
 	{
 		return;
@@ -1,7 +1,6 @@
 #include "spot_light.h"
 
 #include <core/serialized_member.h>
-#include <utils/vectools.h>
 #include <utils/utils.h>
 
 IMPLEMENT_ENTITY(entities::SpotLight);
@@ -18,8 +17,6 @@ namespace entities
 
 using namespace entities;
 
-std::vector<peng::weak_ptr<SpotLight>> SpotLight::_active_lights;
-
 SpotLight::SpotLight()
 	: SpotLight("SpotLight")
 { }
@@ -39,25 +36,6 @@ SpotLight::SpotLight(std::string&& name)
 	SERIALIZED_MEMBER(_data);
 }
 
-const std::vector<peng::weak_ptr<SpotLight>>& SpotLight::active_lights()
-{
-	return _active_lights;
-}
-
-void SpotLight::post_create()
-{
-	Entity::post_create();
-
-	_active_lights.push_back(weak_this());
-}
-
-void SpotLight::pre_destroy()
-{
-	Entity::pre_destroy();
-
-	vectools::remove(_active_lights, weak_this());
-}
-
 SpotLight::LightData& SpotLight::data() noexcept
 {
 	return _data;
@@ -28,17 +28,10 @@ namespace entities
 		explicit SpotLight(const std::string& name);
 		explicit SpotLight(std::string&& name);
 
-		static const std::vector<peng::weak_ptr<SpotLight>>& active_lights();
-
-		void post_create() override;
-		void pre_destroy() override;
-
 		[[nodiscard]] LightData& data() noexcept;
 		[[nodiscard]] const LightData& data() const noexcept;
 
 	private:
-		static std::vector<peng::weak_ptr<SpotLight>> _active_lights;
-
 		LightData _data;
 	};
 }
@@ -7,6 +7,13 @@
 #include "vector4.h"
 #include "quaternion.h"
 
+#if defined(_M_X64) || defined(__SSE__)
+#define PENG_MATRIX_SIMD 1
+#include <xmmintrin.h>
+#else
+#define PENG_MATRIX_SIMD 0
+#endif
+
 namespace math
 {
 	template <number T>
@@ -47,6 +54,10 @@ namespace math
 	using Matrix4x4i = Matrix4x4<int32_t>;
 	using Matrix4x4u = Matrix4x4<uint32_t>;
 
+	// Equivalent to 'lhs * rhs' but uses SSE where available
+	// Intended for hot paths such as building world matrices for large hierarchies
+	[[nodiscard]] inline Matrix4x4f multiply(const Matrix4x4f& lhs, const Matrix4x4f& rhs) noexcept;
+
 	template <number T>
 	constexpr Matrix4x4<T> Matrix4x4<T>::identity()
 	{
@@ -212,4 +223,38 @@ namespace math
 			other.x * this->get(3, 0) + other.y * this->get(3, 1) + other.z * this->get(3, 2) + other.w * this->get(3, 3)
 		);
 	}
+
+	inline Matrix4x4f multiply(const Matrix4x4f& lhs, const Matrix4x4f& rhs) noexcept
+	{
+#if PENG_MATRIX_SIMD
+		// Elements are column major, so each column of the result is the columns
+		// of lhs weighted by the corresponding column of rhs
+		const float* a = lhs.elements.data();
+		const float* b = rhs.elements.data();
+
+		const __m128 col0 = _mm_loadu_ps(a + 0);
+		const __m128 col1 = _mm_loadu_ps(a + 4);
+		const __m128 col2 = _mm_loadu_ps(a + 8);
+		const __m128 col3 = _mm_loadu_ps(a + 12);
+
+		Matrix4x4f result;
+		float* r = result.elements.data();
+
+		for (uint8_t col = 0; col < 4; col++)
+		{
+			const float* weights = b + col * 4;
+
+			__m128 sum = _mm_mul_ps(col0, _mm_set1_ps(weights[0]));
+			sum = _mm_add_ps(sum, _mm_mul_ps(col1, _mm_set1_ps(weights[1])));
+			sum = _mm_add_ps(sum, _mm_mul_ps(col2, _mm_set1_ps(weights[2])));
+			sum = _mm_add_ps(sum, _mm_mul_ps(col3, _mm_set1_ps(weights[3])));
+
+			_mm_storeu_ps(r + col * 4, sum);
+		}
+
+		return result;
+#else
+		return lhs * rhs;
+#endif
+	}
 }
@@ -16,6 +16,15 @@ Transform::Transform(const Vector3f& position, const Vector3f& scale, const Vect
     , rotation(rotation)
 { }
 
+Transform Transform::lerp(const Transform& from, const Transform& to, float alpha) noexcept
+{
+    return Transform(
+        from.position + (to.position - from.position) * alpha,
+        from.scale + (to.scale - from.scale) * alpha,
+        from.rotation + (to.rotation - from.rotation) * alpha
+    );
+}
+
 Matrix4x4f Transform::to_matrix() const noexcept
 {
     return Matrix4x4f::from_scale(scale)
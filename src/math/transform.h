@@ -14,11 +14,16 @@ namespace math
         Transform();
         Transform(const Vector3f& position, const Vector3f& scale, const Vector3f& rotation);
 
+        // Blends each component linearly, rotations are expected to be close together such as between physics steps
+        [[nodiscard]] static Transform lerp(const Transform& from, const Transform& to, float alpha) noexcept;
+
         [[nodiscard]] Matrix4x4f to_matrix() const noexcept;
         [[nodiscard]] Matrix4x4f to_inverse_matrix() const noexcept;
 
         [[nodiscard]] Vector3f local_right() const noexcept;
         [[nodiscard]] Vector3f local_up() const noexcept;
         [[nodiscard]] Vector3f local_forwards() const noexcept;
+
+        [[nodiscard]] bool operator==(const Transform& other) const = default;
     };
 }
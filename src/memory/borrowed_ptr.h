@@ -0,0 +1,98 @@
+#pragma once
+
+#include "shared_ptr.h"
+
+namespace peng
+{
+    // Non-owning view of an object kept alive by a shared_ref or shared_ptr elsewhere
+    // Copying a borrowed_ptr never touches the reference count, so it is intended for frame scoped
+    // data such as render queue internals where the owners are known to outlive every borrow
+    template <typename T>
+    class borrowed_ptr
+    {
+    public:
+        borrowed_ptr() noexcept
+            : _ptr(nullptr)
+        { }
+
+        borrowed_ptr(std::nullptr_t) noexcept
+            : _ptr(nullptr)
+        { }
+
+        // The object must be owned by a shared_ref or shared_ptr elsewhere
+        explicit borrowed_ptr(T* ptr) noexcept
+            : _ptr(ptr)
+        { }
+
+        template <typename U>
+        requires std::convertible_to<U*, T*>
+        borrowed_ptr(const shared_ref<U>& ref) noexcept
+            : _ptr(ref.get())
+        { }
+
+        template <typename U>
+        requires std::convertible_to<U*, T*>
+        borrowed_ptr(const shared_ptr<U>& ptr) noexcept
+            : _ptr(ptr.get())
+        { }
+
+        template <typename U>
+        requires std::convertible_to<U*, T*>
+        borrowed_ptr(const borrowed_ptr<U>& other) noexcept
+            : _ptr(other.get())
+        { }
+
+        [[nodiscard]] T* get() const noexcept
+        {
+            return _ptr;
+        }
+
+        [[nodiscard]] T* operator->() const
+        {
+            check(_ptr);
+            return get();
+        }
+
+        explicit operator bool() const noexcept
+        {
+            return _ptr != nullptr;
+        }
+
+    private:
+        T* _ptr;
+    };
+
+#pragma region Comparison Operators
+
+    template <typename T, typename U>
+    requires std::equality_comparable_with<T*, U*>
+    [[nodiscard]] bool operator==(const borrowed_ptr<T>& a, const borrowed_ptr<U>& b)
+    {
+        return a.get() == b.get();
+    }
+
+    template <typename T, typename U>
+    requires std::equality_comparable_with<T*, U*>
+    [[nodiscard]] bool operator==(const borrowed_ptr<T>& a, const shared_ref<U>& b)
+    {
+        return a.get() == b.get();
+    }
+
+    template <typename T, typename U>
+    requires std::equality_comparable_with<T*, U*>
+    [[nodiscard]] bool operator==(const borrowed_ptr<T>& a, const shared_ptr<U>& b)
+    {
+        return a.get() == b.get();
+    }
+
+#pragma endregion
+}
+
+template<typename T>
+struct std::hash<peng::borrowed_ptr<T>>
+{
+    size_t operator()(const peng::borrowed_ptr<T>& ptr) const
+    {
+        return std::hash<T*>{}(ptr.get());
+    }
+};
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "weak_ptr.h"
+
+namespace peng
+{
+    // Lets an object allocated with make_shared or allocate_shared retrieve references to itself
+    // The object stores a pointer to its own control block, so no lookup or lock is needed
+    template <typename T>
+    class enable_shared_from_this : public detail::SharedFromThisBase
+    {
+    public:
+        // Must not be called while the object is being constructed or destroyed
+        [[nodiscard]] shared_ref<T> shared_from_this()
+        {
+            return make_ref<T>(static_cast<T*>(this));
+        }
+
+        [[nodiscard]] shared_ref<const T> shared_from_this() const
+        {
+            return make_ref<const T>(static_cast<const T*>(this));
+        }
+
+        [[nodiscard]] weak_ptr<T> weak_from_this() noexcept
+        {
+            return make_weak<T>(static_cast<T*>(this));
+        }
+
+        [[nodiscard]] weak_ptr<const T> weak_from_this() const noexcept
+        {
+            return make_weak<const T>(static_cast<const T*>(this));
+        }
+
+    protected:
+        enable_shared_from_this() noexcept = default;
+        enable_shared_from_this(const enable_shared_from_this&) noexcept = default;
+        enable_shared_from_this& operator=(const enable_shared_from_this&) noexcept = default;
+        ~enable_shared_from_this() = default;
+
+    private:
+        template <typename U>
+        [[nodiscard]] shared_ref<U> make_ref(U* object) const
+        {
+            detail::ControlBlock* block = detail::PtrAccess::shared_from_this_block(*this);
+            check(block && !block->expired());
+
+            block->add_strong();
+            return detail::PtrAccess::adopt<shared_ref<U>>(object, block);
+        }
+
+        template <typename U>
+        [[nodiscard]] weak_ptr<U> make_weak(U* object) const noexcept
+        {
+            detail::ControlBlock* block = detail::PtrAccess::shared_from_this_block(*this);
+            if (!block)
+            {
+                return {};
+            }
+
+            block->add_weak();
+            return detail::PtrAccess::adopt<weak_ptr<U>>(object, block);
+        }
+    };
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+#include "frame_arena.h"
+
+namespace memory
+{
+    // Standard allocator adaptor over a FrameArena, by default binding to the arena of the constructing thread
+    // Containers using it must be destroyed before the end of the frame, as the memory is reclaimed on reset
+    template <typename T>
+    class FrameAllocator
+    {
+        template <typename U>
+        friend class FrameAllocator;
+
+    public:
+        using value_type = T;
+
+        FrameAllocator() noexcept
+            : _arena(&FrameArena::current())
+        { }
+
+        explicit FrameAllocator(FrameArena& arena) noexcept
+            : _arena(&arena)
+        { }
+
+        template <typename U>
+        FrameAllocator(const FrameAllocator<U>& other) noexcept
+            : _arena(other._arena)
+        { }
+
+        [[nodiscard]] T* allocate(size_t n)
+        {
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t) noexcept
+        { }
+
+        template <typename U>
+        [[nodiscard]] bool operator==(const FrameAllocator<U>& other) const noexcept
+        {
+            return _arena == other._arena;
+        }
+
+    private:
+        FrameArena* _arena;
+    };
+
+    template <typename T>
+    using frame_vector = std::vector<T, FrameAllocator<T>>;
+
+    template <typename K, typename V, typename Hash = std::hash<K>>
+    using frame_unordered_map = std::unordered_map<K, V, Hash, std::equal_to<K>, FrameAllocator<std::pair<const K, V>>>;
+}
\ No newline at end of file
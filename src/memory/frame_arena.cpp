@@ -0,0 +1,150 @@
+#include "frame_arena.h"
+
+#include <new>
+#include <mutex>
+#include <memory>
+#include <numeric>
+#include <algorithm>
+
+#include <profiling/counter.h>
+#include <utils/check.h>
+
+using namespace memory;
+
+namespace
+{
+    constexpr size_t chunk_alignment = 64;
+
+    // Every live arena, so that all of them can be reset from the main thread at the end of the frame
+    struct ArenaRegistry
+    {
+        std::mutex mutex;
+        std::vector<FrameArena*> arenas;
+    };
+
+    ArenaRegistry& registry()
+    {
+        static ArenaRegistry instance;
+        return instance;
+    }
+
+    // Registers the arena of a thread for the lifetime of the thread
+    struct ThreadArena
+    {
+        ThreadArena()
+        {
+            std::lock_guard lock(registry().mutex);
+            registry().arenas.push_back(&arena);
+        }
+
+        ~ThreadArena()
+        {
+            std::lock_guard lock(registry().mutex);
+            std::erase(registry().arenas, &arena);
+        }
+
+        FrameArena arena;
+    };
+}
+
+FrameArena::FrameArena(size_t chunk_size)
+    : _chunk_size(chunk_size)
+    , _offset(0)
+    , _bytes_used(0)
+{ }
+
+FrameArena::~FrameArena()
+{
+    free_chunks();
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment)
+{
+    check(alignment <= chunk_alignment);
+
+    if (!_chunks.empty())
+    {
+        const Chunk& chunk = _chunks.back();
+        const size_t aligned_offset = (_offset + alignment - 1) & ~(alignment - 1);
+
+        if (aligned_offset + size <= chunk.size)
+        {
+            _offset = aligned_offset + size;
+            _bytes_used += size;
+
+            return chunk.data + aligned_offset;
+        }
+    }
+
+    // Chunks are aligned to the largest supported alignment so a fresh chunk never needs padding
+    add_chunk(size);
+    _offset = size;
+    _bytes_used += size;
+
+    return _chunks.back().data;
+}
+
+void FrameArena::reset()
+{
+    if (_chunks.size() > 1)
+    {
+        const size_t total_size = capacity();
+        free_chunks();
+        add_chunk(total_size);
+    }
+
+    _offset = 0;
+    _bytes_used = 0;
+}
+
+size_t FrameArena::bytes_used() const noexcept
+{
+    return _bytes_used;
+}
+
+size_t FrameArena::capacity() const noexcept
+{
+    return std::accumulate(_chunks.begin(), _chunks.end(), size_t(0),
+        [](size_t total, const Chunk& chunk) { return total + chunk.size; });
+}
+
+FrameArena& FrameArena::current()
+{
+    thread_local ThreadArena thread_arena;
+    return thread_arena.arena;
+}
+
+void FrameArena::reset_all()
+{
+    std::lock_guard lock(registry().mutex);
+
+    size_t bytes_used = 0;
+    for (FrameArena* arena : registry().arenas)
+    {
+        bytes_used += arena->bytes_used();
+        arena->reset();
+    }
+
+    SET_COUNTER("FrameArena - bytes used", bytes_used);
+}
+
+void FrameArena::add_chunk(size_t min_size)
+{
+    const size_t size = std::max(_chunk_size, min_size);
+    std::byte* data = static_cast<std::byte*>(::operator new(size, std::align_val_t(chunk_alignment)));
+
+    _chunks.push_back(Chunk{
+        .data = data,
+        .size = size
+    });
+}
+
+void FrameArena::free_chunks() noexcept
+{
+    for (const Chunk& chunk : _chunks)
+    {
+        ::operator delete(chunk.data, std::align_val_t(chunk_alignment));
+    }
+
+    _chunks.clear();
+}
\ No newline at end of file
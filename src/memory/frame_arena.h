@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+namespace memory
+{
+    // Linear allocator for transient data that never outlives the current frame
+    // Allocation is a pointer bump, individual frees are ignored and everything is released at once on reset
+    // Each thread has its own arena so allocating never needs to synchronize
+    class FrameArena
+    {
+    public:
+        static constexpr size_t default_chunk_size = 256 * 1024;
+
+        explicit FrameArena(size_t chunk_size = default_chunk_size);
+        ~FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena(FrameArena&&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+        FrameArena& operator=(FrameArena&&) = delete;
+
+        [[nodiscard]] void* allocate(size_t size, size_t alignment);
+
+        // Releases every allocation made since the last reset
+        // If the frame needed more than one chunk they are merged so that the next frame fits in a single chunk
+        void reset();
+
+        [[nodiscard]] size_t bytes_used() const noexcept;
+        [[nodiscard]] size_t capacity() const noexcept;
+
+        // Arena of the calling thread, created on first use
+        [[nodiscard]] static FrameArena& current();
+
+        // Resets the arena of every thread
+        // Called once the frame has ended, no other thread may be using its arena while this runs
+        static void reset_all();
+
+    private:
+        struct Chunk
+        {
+            std::byte* data;
+            size_t size;
+        };
+
+        void add_chunk(size_t min_size);
+        void free_chunks() noexcept;
+
+        std::vector<Chunk> _chunks;
+        size_t _chunk_size;
+        size_t _offset;
+        size_t _bytes_used;
+    };
+}
\ No newline at end of file
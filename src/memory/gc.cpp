@@ -1,5 +1,9 @@
 #include "gc.h"
 
+#include <chrono>
+#include <optional>
+
+#include "profiling/counter.h"
 #include "profiling/scoped_event.h"
 
 using namespace memory;
@@ -7,8 +11,42 @@ using namespace memory;
 void GC::tick()
 {
     SCOPED_EVENT("GC - tick");
+    _frame++;
+
+    gather_new_trackers();
     update_trackers();
-    free_garbage();
+    free_garbage(free_budget_ms);
+}
+
+void GC::collect()
+{
+    SCOPED_EVENT("GC - collect");
+
+    gather_new_trackers();
+    for (size_t i = 0; i < _tracked_objects.size();)
+    {
+        if (_tracked_objects[i].dead())
+        {
+            retire_tracker(i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+
+    _scan_cursor = 0;
+    free_garbage(0);
+}
+
+size_t GC::num_tracked() const noexcept
+{
+    return _tracked_objects.size();
+}
+
+size_t GC::num_garbage() const noexcept
+{
+    return _garbage.size();
 }
 
 bool GC::Tracker::dead() const noexcept
@@ -16,32 +54,91 @@ bool GC::Tracker::dead() const noexcept
     return object.use_count() == 1;
 }
 
+void GC::gather_new_trackers()
+{
+    // Trackers have no empty state, so they are dequeued into an optional
+    std::optional<Tracker> tracker;
+    while (_new_trackers.try_dequeue(tracker))
+    {
+        _tracked_objects.push_back(std::move(*tracker));
+    }
+}
+
 void GC::update_trackers()
 {
     SCOPED_EVENT("GC - update trackers");
 
-    for (int32_t i = static_cast<int32_t>(_tracked_objects.size()) - 1; i >= 0; i--)
+    // Only a slice of the trackers is scanned each frame, resuming where the previous scan left off
+    const size_t num_to_scan = std::min(scan_budget, _tracked_objects.size());
+
+    for (size_t scanned = 0; scanned < num_to_scan && !_tracked_objects.empty(); scanned++)
     {
-        Tracker& tracker = _tracked_objects[i];
+        if (_scan_cursor >= _tracked_objects.size())
+        {
+            _scan_cursor = 0;
+        }
 
-        // Reset the dead frames counter if object is alive, otherwise increment it
-        tracker.dead_frames =
-            tracker.dead()
-            ? tracker.dead_frames + 1
-            : 0;
+        Tracker& tracker = _tracked_objects[_scan_cursor];
+        if (!tracker.dead())
+        {
+            tracker.dead_since = -1;
+            _scan_cursor++;
+            continue;
+        }
 
-        // If an tracker has been dead sufficiently long according to it's policy, enqueue for destruction
-        if (tracker.dead_frames >= 2)
+        if (tracker.dead_since < 0)
         {
-            _garbage.push_back(std::move(tracker));
-            _tracked_objects.erase(_tracked_objects.begin() + i);
+            tracker.dead_since = _frame;
+        }
+
+        // If a tracker has been dead sufficiently long according to its policy, enqueue for destruction
+        // The tracker swapped into its slot is scanned next, so the cursor stays put
+        if (_frame - tracker.dead_since >= tracker.policy.dead_frames)
+        {
+            retire_tracker(_scan_cursor);
+        }
+        else
+        {
+            _scan_cursor++;
         }
     }
 }
 
-void GC::free_garbage()
+void GC::free_garbage(float budget_ms)
 {
-    // Currently just free all garbage at once
     SCOPED_EVENT("GC - free garbage");
-    _garbage.clear();
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<float, std::milli>(budget_ms);
+
+    while (!_garbage.empty())
+    {
+        // Objects may have been revived through a weak_ptr since they were retired
+        Tracker& tracker = _garbage.back();
+        if (!tracker.dead())
+        {
+            tracker.dead_since = -1;
+            _tracked_objects.push_back(std::move(tracker));
+        }
+
+        _garbage.pop_back();
+
+        if (budget_ms > 0 && std::chrono::steady_clock::now() - start >= budget)
+        {
+            break;
+        }
+    }
+
+    SET_COUNTER("GC - pending garbage", _garbage.size());
+}
+
+void GC::retire_tracker(size_t index)
+{
+    if (index + 1 != _tracked_objects.size())
+    {
+        std::swap(_tracked_objects[index], _tracked_objects.back());
+    }
+
+    _garbage.push_back(std::move(_tracked_objects.back()));
+    _tracked_objects.pop_back();
 }
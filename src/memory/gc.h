@@ -1,51 +1,106 @@
 #pragma once
 
+#include <common/common.h>
 #include <utils/singleton.h>
 
 #include "shared_ptr.h"
 
 namespace memory
 {
-    // TODO: add more control over GC policies
+    // Controls how long a tracked object may stay dead before it is destroyed
+    // A type may override the default policy by declaring a static constexpr GCPolicy gc_policy member
+    struct GCPolicy
+    {
+        // Number of frames an object must have been without strong references before it is collected
+        int32_t dead_frames = 2;
+    };
+
+    template <typename T>
+    concept has_gc_policy = requires
+    {
+        { T::gc_policy } -> std::convertible_to<GCPolicy>;
+    };
+
     class GC : public utils::Singleton<GC>
     {
         using Singleton::Singleton;
 
     public:
+        // Safe to call from any thread, new objects are handed over to the GC on its next tick
         template <typename T, typename...Args>
         requires std::constructible_from<T, Args...>
         [[nodiscard]] static peng::shared_ref<T> alloc(Args&&...args);
 
+        template <typename T>
+        [[nodiscard]] static constexpr GCPolicy policy_for() noexcept;
+
         void tick();
 
+        // Immediately frees every tracked object without strong references, skipping the usual grace period
+        // Intended for bulk teardown such as unloading a scene, where most garbage is known to be dead already
+        void collect();
+
+        [[nodiscard]] size_t num_tracked() const noexcept;
+        [[nodiscard]] size_t num_garbage() const noexcept;
+
     private:
+        // Maximum number of trackers inspected per tick
+        static constexpr size_t scan_budget = 512;
+
+        // Time spent destroying garbage per tick, at least one object is always destroyed
+        static constexpr float free_budget_ms = 1;
+
         struct Tracker
         {
             peng::shared_ref<void> object;
-            int32_t dead_frames = 0;
+            GCPolicy policy;
+
+            // Frame on which the object was first observed dead, or -1 if it was alive when last scanned
+            int64_t dead_since = -1;
 
             // We consider a tracked object dead if there are no longer any strong
             // references left to it. Dead objects can still be revived via weak_ptrs however
             [[nodiscard]] bool dead() const noexcept;
         };
 
+        void gather_new_trackers();
         void update_trackers();
-        void free_garbage();
-        
+        // A budget of 0 destroys all pending garbage at once
+        void free_garbage(float budget_ms);
+
+        // Removes the tracker at index by swapping it with the last one
+        void retire_tracker(size_t index);
+
+        common::concurrent_queue<Tracker> _new_trackers;
         std::vector<Tracker> _tracked_objects;
         std::vector<Tracker> _garbage;
+
+        size_t _scan_cursor = 0;
+        int64_t _frame = 0;
     };
 
     template <typename T, typename ... Args> requires std::constructible_from<T, Args...>
     peng::shared_ref<T> GC::alloc(Args&&... args)
     {
-        // TODO: make it thread safe to alloc
         peng::shared_ref<T> obj = peng::make_shared<T>(std::forward<Args>(args)...);
-        get()._tracked_objects.push_back(Tracker{
+        get()._new_trackers.enqueue(Tracker{
             .object = obj,
-            .dead_frames = 0
+            .policy = policy_for<T>()
         });
 
         return obj;
     }
+
+    template <typename T>
+    constexpr GCPolicy GC::policy_for() noexcept
+    {
+        if constexpr (has_gc_policy<T>)
+        {
+            return T::gc_policy;
+        }
+        else
+        {
+            return GCPolicy();
+        }
+    }
 }
@@ -0,0 +1,360 @@
+#include "object_pool.h"
+
+#include <new>
+#include <bit>
+#include <utility>
+#include <algorithm>
+
+#include <utils/check.h>
+
+using namespace memory;
+using namespace memory::detail;
+
+namespace memory::detail
+{
+    // A thread's free blocks for a single pool
+    struct PoolThreadCache
+    {
+        ObjectPool* pool;
+        ObjectPool::FreeBlock* head;
+        uint32_t count;
+
+        void flush() noexcept
+        {
+            if (count > 0)
+            {
+                pool->flush(*this, count);
+            }
+        }
+    };
+}
+
+namespace
+{
+    std::atomic<size_t> next_pool_index = 0;
+
+    // Trivially destructible so that it stays usable while the thread's other thread locals are destroyed
+    struct ThreadState
+    {
+        PoolThreadCache caches[ObjectPool::max_pools];
+        bool flush_registered;
+
+        // Set once the caches have been flushed on thread exit, later requests go straight to the slabs
+        bool exited;
+    };
+
+    constinit thread_local ThreadState thread_state = {};
+
+    // Returns every cached block to its pool when the thread exits
+    struct ThreadFlusher
+    {
+        ~ThreadFlusher()
+        {
+            thread_state.exited = true;
+            for (PoolThreadCache& cache : thread_state.caches)
+            {
+                cache.flush();
+            }
+        }
+    };
+
+    void register_thread_flush() noexcept
+    {
+        thread_local ThreadFlusher flusher;
+        thread_state.flush_registered = true;
+    }
+
+    [[nodiscard]] constexpr size_t round_up(size_t value, size_t multiple) noexcept
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+}
+
+ObjectPool::ObjectPool(std::string&& name)
+    : _name(std::move(name))
+    , _index(next_pool_index.fetch_add(1, std::memory_order_relaxed))
+    , _block_size(0)
+    , _slab_bytes(0)
+    , _first_block_offset(0)
+    , _blocks_per_slab(0)
+    , _partial_slabs(nullptr)
+    , _empty_slab(nullptr)
+    , _num_outstanding(0)
+{
+    check(_index < max_pools);
+}
+
+ObjectPool::~ObjectPool()
+{
+    // Pools are destroyed during static destruction, which may come before the thread locals of the
+    // destroying thread are, so its cache is flushed here. Every other thread has flushed on exit
+    thread_state.caches[_index].flush();
+
+    check(_num_outstanding == 0);
+
+    // Objects that outlive the pool are leaked rather than left pointing into freed slabs
+    if (_num_outstanding > 0)
+    {
+        return;
+    }
+
+    // Every slab is released as it empties apart from the one kept spare
+    check(!_partial_slabs);
+    if (_empty_slab)
+    {
+        ::operator delete(_empty_slab, std::align_val_t(_slab_bytes));
+    }
+}
+
+void* ObjectPool::allocate(size_t size, size_t alignment)
+{
+    if (alignment > block_alignment)
+    {
+        return nullptr;
+    }
+
+    const size_t block_size = _block_size.load(std::memory_order_acquire);
+    if (block_size == 0)
+    {
+        if (!init_block_size(size))
+        {
+            return nullptr;
+        }
+    }
+    else if (size > block_size)
+    {
+        return nullptr;
+    }
+
+    if (thread_state.exited)
+    {
+        // The thread's caches have already been flushed, so blocks are taken straight from the slabs
+        PoolThreadCache cache = { .pool = this, .head = nullptr, .count = 0 };
+        refill(cache);
+
+        FreeBlock* block = cache.head;
+        cache.head = block->next;
+        cache.count--;
+        cache.flush();
+
+        return block;
+    }
+
+    PoolThreadCache& cache = thread_state.caches[_index];
+    if (cache.count == 0)
+    {
+        refill(cache);
+    }
+
+    FreeBlock* block = cache.head;
+    cache.head = block->next;
+    cache.count--;
+
+    return block;
+}
+
+bool ObjectPool::deallocate(void* block, size_t size, size_t alignment) noexcept
+{
+    // Mirrors the checks in allocate, which never change once the block size has been fixed
+    if (alignment > block_alignment || size > _block_size.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    FreeBlock* free_block = static_cast<FreeBlock*>(block);
+
+    if (thread_state.exited)
+    {
+        std::lock_guard lock(_mutex);
+        return_block(free_block);
+
+        return true;
+    }
+
+    PoolThreadCache& cache = thread_state.caches[_index];
+    if (cache.count == thread_cache_capacity)
+    {
+        flush(cache, thread_cache_batch);
+    }
+
+    // Blocks freed on a thread that never allocated from the pool still need returning on exit
+    if (!thread_state.flush_registered)
+    {
+        register_thread_flush();
+    }
+
+    cache.pool = this;
+    free_block->next = cache.head;
+    cache.head = free_block;
+    cache.count++;
+
+    return true;
+}
+
+bool ObjectPool::init_block_size(size_t size)
+{
+    std::lock_guard lock(_mutex);
+
+    if (_block_size.load(std::memory_order_relaxed) == 0)
+    {
+        const size_t block_size = round_up(std::max(size, sizeof(FreeBlock)), block_alignment);
+
+        _first_block_offset = round_up(sizeof(Slab), block_alignment);
+        _slab_bytes = std::bit_ceil(std::max(slab_size, _first_block_offset + block_size));
+        _blocks_per_slab = (_slab_bytes - _first_block_offset) / block_size;
+
+        _block_size.store(block_size, std::memory_order_release);
+    }
+
+    return size <= _block_size.load(std::memory_order_relaxed);
+}
+
+void ObjectPool::refill(PoolThreadCache& cache)
+{
+    std::lock_guard lock(_mutex);
+
+    for (uint32_t i = 0; i < thread_cache_batch; i++)
+    {
+        Slab* slab = _partial_slabs ? _partial_slabs : acquire_slab();
+
+        FreeBlock* block = slab->free_list;
+        slab->free_list = block->next;
+
+        if (--slab->num_free == 0)
+        {
+            unlink_partial(slab);
+        }
+
+        block->next = cache.head;
+        cache.head = block;
+        cache.count++;
+        _num_outstanding++;
+    }
+
+    cache.pool = this;
+    if (!thread_state.exited && !thread_state.flush_registered)
+    {
+        register_thread_flush();
+    }
+}
+
+void ObjectPool::flush(PoolThreadCache& cache, uint32_t count) noexcept
+{
+    std::lock_guard lock(_mutex);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        FreeBlock* block = cache.head;
+        cache.head = block->next;
+        cache.count--;
+
+        return_block(block);
+    }
+}
+
+void ObjectPool::return_block(FreeBlock* block) noexcept
+{
+    check(_num_outstanding > 0);
+    _num_outstanding--;
+
+    Slab* slab = reinterpret_cast<Slab*>(reinterpret_cast<uintptr_t>(block) & ~(_slab_bytes - 1));
+    block->next = slab->free_list;
+    slab->free_list = block;
+
+    if (slab->num_free++ == 0)
+    {
+        link_partial(slab);
+    }
+
+    if (slab->num_free == _blocks_per_slab)
+    {
+        release_slab(slab);
+    }
+}
+
+ObjectPool::Slab* ObjectPool::acquire_slab()
+{
+    Slab* slab = std::exchange(_empty_slab, nullptr);
+
+    if (!slab)
+    {
+        std::byte* memory = static_cast<std::byte*>(::operator new(_slab_bytes, std::align_val_t(_slab_bytes)));
+        slab = ::new (memory) Slab{
+            .free_list = nullptr,
+            .num_free = _blocks_per_slab,
+            .prev = nullptr,
+            .next = nullptr
+        };
+
+        // Blocks are threaded onto the free list in address order so consecutive allocations are adjacent
+        for (size_t i = _blocks_per_slab; i > 0; i--)
+        {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(memory + _first_block_offset + (i - 1) * _block_size.load(std::memory_order_relaxed));
+            block->next = slab->free_list;
+            slab->free_list = block;
+        }
+    }
+
+    link_partial(slab);
+    return slab;
+}
+
+void ObjectPool::release_slab(Slab* slab) noexcept
+{
+    unlink_partial(slab);
+
+    // One empty slab is kept so that a pool hovering around a slab boundary doesn't repeatedly reallocate it
+    if (!_empty_slab)
+    {
+        _empty_slab = slab;
+        return;
+    }
+
+    ::operator delete(slab, std::align_val_t(_slab_bytes));
+}
+
+void ObjectPool::link_partial(Slab* slab) noexcept
+{
+    slab->prev = nullptr;
+    slab->next = _partial_slabs;
+
+    if (_partial_slabs)
+    {
+        _partial_slabs->prev = slab;
+    }
+
+    _partial_slabs = slab;
+}
+
+void ObjectPool::unlink_partial(Slab* slab) noexcept
+{
+    if (slab->prev)
+    {
+        slab->prev->next = slab->next;
+    }
+    else
+    {
+        _partial_slabs = slab->next;
+    }
+
+    if (slab->next)
+    {
+        slab->next->prev = slab->prev;
+    }
+
+    slab->prev = nullptr;
+    slab->next = nullptr;
+}
+
+ObjectPool& PoolRegistry::find_or_create_pool(const std::type_info& type)
+{
+    std::lock_guard lock(_mutex);
+
+    std::unique_ptr<ObjectPool>& pool = _pools[std::type_index(type)];
+    if (!pool)
+    {
+        pool = std::make_unique<ObjectPool>(type.name());
+    }
+
+    return *pool;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <typeindex>
+#include <unordered_map>
+
+#include <utils/singleton.h>
+
+namespace memory
+{
+    namespace detail
+    {
+        struct PoolThreadCache;
+    }
+
+    // Fixed size block allocator that carves cache line aligned blocks out of large slabs
+    // Every thread keeps a small cache of free blocks for each pool, so allocating and freeing normally touch
+    // no shared state. Caches exchange blocks with the slabs in batches, and a slab is released once all of
+    // its blocks have been returned, keeping a single empty slab around to absorb churn at slab boundaries
+    class ObjectPool
+    {
+    public:
+        static constexpr size_t block_alignment = 64;
+        static constexpr size_t slab_size = 64 * 1024;
+
+        // Blocks a thread may cache for each pool, half of which are moved at a time when it empties or fills
+        static constexpr uint32_t thread_cache_capacity = 64;
+        static constexpr uint32_t thread_cache_batch = thread_cache_capacity / 2;
+
+        // Every thread reserves a cache for each pool up front, which bounds the number of pools
+        static constexpr size_t max_pools = 256;
+
+        explicit ObjectPool(std::string&& name);
+        ~ObjectPool();
+
+        ObjectPool(const ObjectPool&) = delete;
+        ObjectPool(ObjectPool&&) = delete;
+
+        // Returns nullptr if the request can't be served by this pool, callers should fall back to the heap
+        // The block size is fixed by the first allocation and rounded up to a whole number of cache lines
+        [[nodiscard]] void* allocate(size_t size, size_t alignment);
+
+        // Returns false if the block didn't come from this pool
+        bool deallocate(void* block, size_t size, size_t alignment) noexcept;
+
+    private:
+        friend detail::PoolThreadCache;
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        // Header at the start of each slab, slabs are aligned to their size so a block can find its slab
+        struct Slab
+        {
+            FreeBlock* free_list;
+            size_t num_free;
+
+            // Links within the list of slabs that have free blocks
+            Slab* prev;
+            Slab* next;
+        };
+
+        // Fixes the block size on the first allocation, returns false if the request can't be served
+        [[nodiscard]] bool init_block_size(size_t size);
+
+        // Moves a batch of free blocks from the slabs into the calling thread's cache
+        void refill(detail::PoolThreadCache& cache);
+
+        // Moves count blocks from the head of the calling thread's cache back to their slabs
+        void flush(detail::PoolThreadCache& cache, uint32_t count) noexcept;
+
+        // Must be called with the mutex held
+        void return_block(FreeBlock* block) noexcept;
+        [[nodiscard]] Slab* acquire_slab();
+        void release_slab(Slab* slab) noexcept;
+        void link_partial(Slab* slab) noexcept;
+        void unlink_partial(Slab* slab) noexcept;
+
+        std::string _name;
+        size_t _index;
+
+        // Read without the mutex, so published once the slab layout has been fixed
+        std::atomic<size_t> _block_size;
+        size_t _slab_bytes;
+        size_t _first_block_offset;
+        size_t _blocks_per_slab;
+
+        Slab* _partial_slabs;
+        Slab* _empty_slab;
+
+        // Blocks taken out of the slabs, either live or sitting in a thread cache
+        size_t _num_outstanding;
+
+        std::mutex _mutex;
+    };
+
+    // Owns one pool per object type so that objects of the same type are packed together
+    class PoolRegistry : public utils::Singleton<PoolRegistry>
+    {
+        using Singleton::Singleton;
+
+    public:
+        [[nodiscard]] ObjectPool& find_or_create_pool(const std::type_info& type);
+
+        template <typename T>
+        [[nodiscard]] static ObjectPool& pool();
+
+    private:
+        std::unordered_map<std::type_index, std::unique_ptr<ObjectPool>> _pools;
+        std::mutex _mutex;
+    };
+
+    template <typename T>
+    ObjectPool& PoolRegistry::pool()
+    {
+        // Cached per type so that the registry lookup only happens once
+        static ObjectPool& pool = get().find_or_create_pool(typeid(T));
+        return pool;
+    }
+}
\ No newline at end of file
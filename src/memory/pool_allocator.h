@@ -0,0 +1,63 @@
+#pragma once
+
+#include <new>
+#include <cstddef>
+
+#include "object_pool.h"
+
+namespace memory
+{
+    // Standard allocator adaptor over an ObjectPool, intended for use with allocate_shared so that
+    // the object and its control block share a single pooled block
+    // Requests the pool can't serve fall back to the global heap
+    template <typename T>
+    class PoolAllocator
+    {
+        template <typename U>
+        friend class PoolAllocator;
+
+    public:
+        using value_type = T;
+
+        explicit PoolAllocator(ObjectPool& pool) noexcept
+            : _pool(&pool)
+        { }
+
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U>& other) noexcept
+            : _pool(other._pool)
+        { }
+
+        [[nodiscard]] T* allocate(size_t n)
+        {
+            if (n == 1)
+            {
+                if (void* block = _pool->allocate(sizeof(T), alignof(T)))
+                {
+                    return static_cast<T*>(block);
+                }
+            }
+
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* ptr, size_t n) noexcept
+        {
+            if (n == 1 && _pool->deallocate(ptr, sizeof(T), alignof(T)))
+            {
+                return;
+            }
+
+            ::operator delete(ptr, n * sizeof(T), std::align_val_t(alignof(T)));
+        }
+
+        template <typename U>
+        [[nodiscard]] bool operator==(const PoolAllocator<U>& other) const noexcept
+        {
+            return _pool == other._pool;
+        }
+
+    private:
+        ObjectPool* _pool;
+    };
+}
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <concepts>
+
+namespace peng
+{
+    // Controls whether reference counts of an object are updated atomically
+    // Local counts are cheaper but the object must only ever be referenced from one thread at a time
+    enum class RefCountPolicy : uint8_t
+    {
+        atomic,
+        local
+    };
+
+    // A type may opt into a different policy by declaring a static constexpr RefCountPolicy ref_count_policy member
+    template <typename T>
+    concept has_ref_count_policy = requires
+    {
+        { T::ref_count_policy } -> std::convertible_to<RefCountPolicy>;
+    };
+
+    template <typename T>
+    [[nodiscard]] constexpr RefCountPolicy ref_count_policy_for() noexcept
+    {
+        if constexpr (has_ref_count_policy<T>)
+        {
+            return T::ref_count_policy;
+        }
+        else
+        {
+            return RefCountPolicy::atomic;
+        }
+    }
+
+    namespace detail
+    {
+        // Strong and weak counts shared by every reference to an object
+        // The object is destroyed when the last strong reference is released, and the
+        // block itself once the last weak reference is released. All strong references
+        // collectively hold a single weak reference so the block outlives the object
+        class ControlBlock
+        {
+        public:
+            explicit ControlBlock(RefCountPolicy policy) noexcept
+                : _strong(1)
+                , _weak(1)
+                , _policy(policy)
+            { }
+
+            ControlBlock(const ControlBlock&) = delete;
+            ControlBlock(ControlBlock&&) = delete;
+            ControlBlock& operator=(const ControlBlock&) = delete;
+            ControlBlock& operator=(ControlBlock&&) = delete;
+
+            void add_strong() noexcept
+            {
+                increment(_strong);
+            }
+
+            void release_strong() noexcept
+            {
+                if (decrement(_strong))
+                {
+                    destroy_object();
+                    release_weak();
+                }
+            }
+
+            // Acquires a strong reference unless the object has already been destroyed
+            [[nodiscard]] bool try_add_strong() noexcept
+            {
+                if (_policy == RefCountPolicy::local)
+                {
+                    const int32_t count = _strong.load(std::memory_order_relaxed);
+                    if (count == 0)
+                    {
+                        return false;
+                    }
+
+                    _strong.store(count + 1, std::memory_order_relaxed);
+                    return true;
+                }
+
+                int32_t count = _strong.load(std::memory_order_relaxed);
+                while (count != 0)
+                {
+                    if (_strong.compare_exchange_weak(count, count + 1, std::memory_order_relaxed))
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            void add_weak() noexcept
+            {
+                increment(_weak);
+            }
+
+            void release_weak() noexcept
+            {
+                if (decrement(_weak))
+                {
+                    deallocate();
+                }
+            }
+
+            [[nodiscard]] size_t strong_count() const noexcept
+            {
+                return static_cast<size_t>(_strong.load(std::memory_order_relaxed));
+            }
+
+            [[nodiscard]] bool expired() const noexcept
+            {
+                return _strong.load(std::memory_order_acquire) == 0;
+            }
+
+            [[nodiscard]] RefCountPolicy policy() const noexcept
+            {
+                return _policy;
+            }
+
+        protected:
+            virtual ~ControlBlock() = default;
+
+            virtual void destroy_object() noexcept = 0;
+            virtual void deallocate() noexcept = 0;
+
+        private:
+            // Local counts still live in an atomic so both policies share a layout, but relaxed
+            // loads and stores compile down to plain memory operations
+            void increment(std::atomic<int32_t>& count) const noexcept
+            {
+                if (_policy == RefCountPolicy::local)
+                {
+                    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    count.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            // Returns true if this released the last reference
+            [[nodiscard]] bool decrement(std::atomic<int32_t>& count) const noexcept
+            {
+                if (_policy == RefCountPolicy::local)
+                {
+                    const int32_t remaining = count.load(std::memory_order_relaxed) - 1;
+                    count.store(remaining, std::memory_order_relaxed);
+                    return remaining == 0;
+                }
+
+                return count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+            }
+
+            std::atomic<int32_t> _strong;
+            std::atomic<int32_t> _weak;
+            RefCountPolicy _policy;
+        };
+
+        // Control block with the object stored inline, so that both share a single allocation
+        template <typename T, typename Alloc>
+        class InplaceControlBlock final : public ControlBlock
+        {
+        public:
+            template <typename...Args>
+            explicit InplaceControlBlock(const Alloc& allocator, Args&&...args)
+                : ControlBlock(ref_count_policy_for<T>())
+                , _allocator(allocator)
+            {
+                std::construct_at(value(), std::forward<Args>(args)...);
+            }
+
+            [[nodiscard]] T* value() noexcept
+            {
+                return reinterpret_cast<T*>(&_storage);
+            }
+
+        private:
+            using BlockAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<InplaceControlBlock>;
+
+            void destroy_object() noexcept override
+            {
+                std::destroy_at(value());
+            }
+
+            void deallocate() noexcept override
+            {
+                BlockAllocator allocator(_allocator);
+                std::destroy_at(this);
+                std::allocator_traits<BlockAllocator>::deallocate(allocator, this, 1);
+            }
+
+            Alloc _allocator;
+            alignas(T) std::byte _storage[sizeof(T)];
+        };
+
+        // Base of enable_shared_from_this, lets make_shared find the object's control block
+        class SharedFromThisBase
+        {
+        protected:
+            SharedFromThisBase() noexcept = default;
+
+            // Copies of an object are distinct objects with their own control block
+            SharedFromThisBase(const SharedFromThisBase&) noexcept
+                : _control_block(nullptr)
+            { }
+
+            SharedFromThisBase& operator=(const SharedFromThisBase&) noexcept
+            {
+                return *this;
+            }
+
+            ~SharedFromThisBase() = default;
+
+            ControlBlock* _control_block = nullptr;
+
+            friend struct PtrAccess;
+        };
+
+        // Grants the free functions and pointer types access to each other's internals
+        struct PtrAccess
+        {
+            template <typename Ptr, typename T>
+            [[nodiscard]] static Ptr adopt(T* ptr, ControlBlock* block) noexcept
+            {
+                return Ptr(ptr, block);
+            }
+
+            template <typename Ptr>
+            [[nodiscard]] static ControlBlock* block(const Ptr& ptr) noexcept
+            {
+                return ptr._block;
+            }
+
+            template <typename Ptr>
+            [[nodiscard]] static auto raw(const Ptr& ptr) noexcept
+            {
+                return ptr._ptr;
+            }
+
+            template <typename Ptr>
+            [[nodiscard]] static auto live(const Ptr& ptr) noexcept
+            {
+                return ptr.live_ptr();
+            }
+
+            static void bind_shared_from_this(SharedFromThisBase& object, ControlBlock* block) noexcept
+            {
+                object._control_block = block;
+            }
+
+            [[nodiscard]] static ControlBlock* shared_from_this_block(const SharedFromThisBase& object) noexcept
+            {
+                return object._control_block;
+            }
+        };
+
+        template <typename T, typename Alloc, typename...Args>
+        [[nodiscard]] InplaceControlBlock<std::remove_cv_t<T>, Alloc>* allocate_control_block(const Alloc& allocator, Args&&...args)
+        {
+            using Block = InplaceControlBlock<std::remove_cv_t<T>, Alloc>;
+            using BlockAllocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+
+            BlockAllocator block_allocator(allocator);
+            Block* block = std::allocator_traits<BlockAllocator>::allocate(block_allocator, 1);
+
+            try
+            {
+                std::construct_at(block, allocator, std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                std::allocator_traits<BlockAllocator>::deallocate(block_allocator, block, 1);
+                throw;
+            }
+
+            if constexpr (std::derived_from<std::remove_cv_t<T>, SharedFromThisBase>)
+            {
+                PtrAccess::bind_shared_from_this(*block->value(), block);
+            }
+
+            return block;
+        }
+    }
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <utility>
 #include <functional>
 
 #include "shared_ref.h"
@@ -9,50 +10,89 @@ namespace peng
     template <typename T>
     class shared_ptr
     {
+        template <typename U>
+        friend class shared_ptr;
+        friend detail::PtrAccess;
+
     public:
-        shared_ptr()
-            : _ptr()
+        shared_ptr() noexcept
+            : _ptr(nullptr)
+            , _block(nullptr)
         { }
 
-        shared_ptr(std::shared_ptr<T>&& ptr)
-            : _ptr(ptr)
-        { }
+        shared_ptr(const shared_ptr& other) noexcept
+            : _ptr(other._ptr)
+            , _block(other._block)
+        {
+            acquire();
+        }
 
-        shared_ptr(const shared_ref<T>& ref)
-            : _ptr(ref.get_impl())
+        shared_ptr(shared_ptr&& other) noexcept
+            : _ptr(std::exchange(other._ptr, nullptr))
+            , _block(std::exchange(other._block, nullptr))
         { }
 
+        shared_ptr(const shared_ref<T>& ref) noexcept
+            : _ptr(ref.get())
+            , _block(detail::PtrAccess::block(ref))
+        {
+            acquire();
+        }
+
         template <typename U>
         requires std::convertible_to<U*, T*>
-        shared_ptr(const shared_ptr<U>& other)
-            : _ptr(other.get_impl())
-        { }
+        shared_ptr(const shared_ptr<U>& other) noexcept
+            : _ptr(other._ptr)
+            , _block(other._block)
+        {
+            acquire();
+        }
+
+        ~shared_ptr()
+        {
+            release();
+        }
+
+        shared_ptr& operator=(const shared_ptr& other) noexcept
+        {
+            shared_ptr(other).swap(*this);
+            return *this;
+        }
+
+        shared_ptr& operator=(shared_ptr&& other) noexcept
+        {
+            shared_ptr(std::move(other)).swap(*this);
+            return *this;
+        }
 
         template <typename U>
         requires std::convertible_to<U*, T*>
-        shared_ptr& operator=(const shared_ref<U>& other)
+        shared_ptr& operator=(const shared_ref<U>& other) noexcept
         {
-            _ptr = other.get_impl();
+            detail::ControlBlock* block = detail::PtrAccess::block(other);
+            block->add_strong();
+
+            shared_ptr(other.get(), block).swap(*this);
             return *this;
         }
 
         template <typename U>
         requires std::convertible_to<U*, T*>
-        shared_ptr& operator=(const shared_ptr<U>& other)
+        shared_ptr& operator=(const shared_ptr<U>& other) noexcept
         {
-            _ptr = other.get_impl();
+            shared_ptr(other).swap(*this);
             return *this;
         }
 
-        shared_ptr& operator=(std::nullptr_t)
+        shared_ptr& operator=(std::nullptr_t) noexcept
         {
-            _ptr = nullptr;
+            shared_ptr().swap(*this);
             return *this;
         }
 
         [[nodiscard]] T* get() const noexcept
         {
-            return _ptr.get();
+            return _ptr;
         }
 
         [[nodiscard]] T* operator->() const
@@ -61,16 +101,14 @@ namespace peng
             return get();
         }
 
-        [[nodiscard]] size_t use_count() const noexcept { return _ptr.use_count(); }
-
-        [[nodiscard]] const std::shared_ptr<T>& get_impl() const noexcept
-        { 
-            return _ptr;
-        }
+        [[nodiscard]] size_t use_count() const noexcept { return _block ? _block->strong_count() : 0; }
 
         [[nodiscard]] shared_ref<T> to_shared_ref() const noexcept
         {
-            return shared_ref<T>(_ptr);
+            check(_block);
+            _block->add_strong();
+
+            return detail::PtrAccess::adopt<shared_ref<T>>(_ptr, _block);
         }
 
         shared_ptr& if_valid(const std::function<void(T&)>& func)
@@ -89,9 +127,51 @@ namespace peng
         }
 
     private:
-        std::shared_ptr<T> _ptr;
+        // Adopts a strong reference that has already been acquired on the block
+        shared_ptr(T* ptr, detail::ControlBlock* block) noexcept
+            : _ptr(ptr)
+            , _block(block)
+        { }
+
+        void acquire() const noexcept
+        {
+            if (_block)
+            {
+                _block->add_strong();
+            }
+        }
+
+        void release() noexcept
+        {
+            if (_block)
+            {
+                _block->release_strong();
+            }
+        }
+
+        void swap(shared_ptr& other) noexcept
+        {
+            std::swap(_ptr, other._ptr);
+            std::swap(_block, other._block);
+        }
+
+        T* _ptr;
+        detail::ControlBlock* _block;
     };
 
+    template <typename T, typename U>
+    [[nodiscard]] shared_ptr<T> static_pointer_cast(const shared_ptr<U>& ptr) noexcept
+    {
+        detail::ControlBlock* block = detail::PtrAccess::block(ptr);
+        if (!block)
+        {
+            return {};
+        }
+
+        block->add_strong();
+        return detail::PtrAccess::adopt<shared_ptr<T>>(static_cast<T*>(ptr.get()), block);
+    }
+
 #pragma region Comparison Operators
 
     template <typename T, typename U>
@@ -1,56 +1,118 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 #include <stdexcept>
 
 #include <utils/check.h>
 
+#include "ref_count.h"
+
 namespace peng
 {
     template <typename T>
     class shared_ref
     {
+        template <typename U>
+        friend class shared_ref;
+        friend detail::PtrAccess;
+
     public:
         shared_ref() = delete;
 
-        explicit shared_ref(const std::shared_ptr<T>& ptr)
-            : _ptr(ptr)
+        shared_ref(const shared_ref& other) noexcept
+            : _ptr(other._ptr)
+            , _block(other._block)
         {
-            check(_ptr);
+            if (_block)
+            {
+                _block->add_strong();
+            }
         }
 
+        // A moved from reference is left unbound and may only be assigned to or destroyed
+        shared_ref(shared_ref&& other) noexcept
+            : _ptr(std::exchange(other._ptr, nullptr))
+            , _block(std::exchange(other._block, nullptr))
+        { }
+
         template <typename U>
         requires std::convertible_to<U*, T*>
-        shared_ref(const shared_ref<U>& other)
-            : _ptr(other.get_impl())
-        { }
+        shared_ref(const shared_ref<U>& other) noexcept
+            : _ptr(other._ptr)
+            , _block(other._block)
+        {
+            if (_block)
+            {
+                _block->add_strong();
+            }
+        }
+
+        ~shared_ref()
+        {
+            if (_block)
+            {
+                _block->release_strong();
+            }
+        }
+
+        shared_ref& operator=(const shared_ref& other) noexcept
+        {
+            shared_ref(other).swap(*this);
+            return *this;
+        }
+
+        shared_ref& operator=(shared_ref&& other) noexcept
+        {
+            shared_ref(std::move(other)).swap(*this);
+            return *this;
+        }
 
         template <typename U>
         requires std::convertible_to<U*, T*>
-        shared_ref& operator=(const shared_ref<U>& other)
+        shared_ref& operator=(const shared_ref<U>& other) noexcept
         {
-            _ptr = other.get_impl();
+            shared_ref(other).swap(*this);
             return *this;
         }
 
-        [[nodiscard]] T* get() const noexcept { return _ptr.get(); }
+        [[nodiscard]] T* get() const noexcept { return _ptr; }
         [[nodiscard]] T* operator->() const noexcept { return get(); }
-        [[nodiscard]] size_t use_count() const noexcept { return _ptr.use_count(); }
+        [[nodiscard]] size_t use_count() const noexcept { return _block ? _block->strong_count() : 0; }
 
-        [[nodiscard]] const std::shared_ptr<T>& get_impl() const noexcept
+    private:
+        // Adopts a strong reference that has already been acquired on the block
+        shared_ref(T* ptr, detail::ControlBlock* block) noexcept
+            : _ptr(ptr)
+            , _block(block)
         {
-            return _ptr;
+            check(_ptr);
         }
 
-    private:
-        std::shared_ptr<T> _ptr;
+        void swap(shared_ref& other) noexcept
+        {
+            std::swap(_ptr, other._ptr);
+            std::swap(_block, other._block);
+        }
+
+        T* _ptr;
+        detail::ControlBlock* _block;
     };
 
+    // Allocates the object and its control block together using the provided allocator
+    template <typename T, typename Alloc, typename...Args>
+    requires std::constructible_from<T, Args...>
+    [[nodiscard]] shared_ref<T> allocate_shared(const Alloc& allocator, Args&&...args)
+    {
+        auto* block = detail::allocate_control_block<T>(allocator, std::forward<Args>(args)...);
+        return detail::PtrAccess::adopt<shared_ref<T>>(static_cast<T*>(block->value()), block);
+    }
+
     template <typename T, typename...Args>
     requires std::constructible_from<T, Args...>
     [[nodiscard]] shared_ref<T> make_shared(Args&&...args)
     {
-        return shared_ref<T>(std::make_shared<T>(std::forward<Args>(args)...));
+        return allocate_shared<T>(std::allocator<std::remove_cv_t<T>>(), std::forward<Args>(args)...);
     }
 
     template <std::copy_constructible T>
@@ -59,6 +121,15 @@ namespace peng
         return make_shared<std::remove_const_t<T>>(*ref.get());
     }
 
+    template <typename T, typename U>
+    [[nodiscard]] shared_ref<T> static_pointer_cast(const shared_ref<U>& ref) noexcept
+    {
+        detail::ControlBlock* block = detail::PtrAccess::block(ref);
+        block->add_strong();
+
+        return detail::PtrAccess::adopt<shared_ref<T>>(static_cast<T*>(ref.get()), block);
+    }
+
 #pragma region Comparison Operators
 
     template <typename T, typename U>
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include "shared_ptr.h"
 
 namespace peng
@@ -7,69 +9,118 @@ namespace peng
     template <typename T>
     class weak_ptr
     {
+        template <typename U>
+        friend class weak_ptr;
+        friend detail::PtrAccess;
+
     public:
-        weak_ptr()
-            : _ptr()
+        weak_ptr() noexcept
+            : _ptr(nullptr)
+            , _block(nullptr)
         { }
 
-        weak_ptr(const shared_ref<T>& ref)
-            : _ptr(ref.get_impl())
-        { }
+        weak_ptr(const weak_ptr& other) noexcept
+            : _ptr(other._ptr)
+            , _block(other._block)
+        {
+            acquire();
+        }
 
-        weak_ptr(const shared_ptr<T>& ptr)
-            : _ptr(ptr.get_impl())
+        weak_ptr(weak_ptr&& other) noexcept
+            : _ptr(std::exchange(other._ptr, nullptr))
+            , _block(std::exchange(other._block, nullptr))
         { }
 
+        weak_ptr(const shared_ref<T>& ref) noexcept
+            : _ptr(ref.get())
+            , _block(detail::PtrAccess::block(ref))
+        {
+            acquire();
+        }
+
+        weak_ptr(const shared_ptr<T>& ptr) noexcept
+            : _ptr(ptr.get())
+            , _block(detail::PtrAccess::block(ptr))
+        {
+            acquire();
+        }
+
         template <typename U>
         requires std::convertible_to<U*, T*>
-        weak_ptr(const weak_ptr<U>& other)
-            : _ptr(std::static_pointer_cast<T>(other.lock().get_impl()))
-        { }
+        weak_ptr(const weak_ptr<U>& other) noexcept
+            : _ptr(other._ptr)
+            , _block(other._block)
+        {
+            acquire();
+        }
+
+        ~weak_ptr()
+        {
+            release();
+        }
+
+        weak_ptr& operator=(const weak_ptr& other) noexcept
+        {
+            weak_ptr(other).swap(*this);
+            return *this;
+        }
+
+        weak_ptr& operator=(weak_ptr&& other) noexcept
+        {
+            weak_ptr(std::move(other)).swap(*this);
+            return *this;
+        }
 
         template <typename U>
         requires std::convertible_to<U*, T*>
-        weak_ptr& operator=(const shared_ref<U>& other)
+        weak_ptr& operator=(const shared_ref<U>& other) noexcept
         {
-            _ptr = other.get_impl();
+            weak_ptr(other.get(), detail::PtrAccess::block(other)).acquired().swap(*this);
             return *this;
         }
 
         template <typename U>
         requires std::convertible_to<U*, T*>
-        weak_ptr& operator=(const shared_ptr<U>& other)
+        weak_ptr& operator=(const shared_ptr<U>& other) noexcept
         {
-            _ptr = other.get_impl();
+            weak_ptr(other.get(), detail::PtrAccess::block(other)).acquired().swap(*this);
             return *this;
         }
 
         template <typename U>
         requires std::convertible_to<U*, T*>
-        weak_ptr& operator=(const weak_ptr<U>& other)
+        weak_ptr& operator=(const weak_ptr<U>& other) noexcept
         {
-            _ptr = std::static_pointer_cast<T>(other.lock().get_impl());
+            weak_ptr(other).swap(*this);
             return *this;
         }
 
-        weak_ptr& operator=(std::nullptr_t)
+        weak_ptr& operator=(std::nullptr_t) noexcept
         {
-            _ptr = nullptr;
+            weak_ptr().swap(*this);
             return *this;
         }
 
         [[nodiscard]] shared_ptr<T> lock() const noexcept
         {
-            return shared_ptr<T>(_ptr.lock());
+            if (_block && _block->try_add_strong())
+            {
+                return detail::PtrAccess::adopt<shared_ptr<T>>(_ptr, _block);
+            }
+
+            return {};
         }
 
-        [[nodiscard]] T* operator->() const 
+        // Does not take a strong reference, the object must be kept alive by its owners for the duration of the access
+        [[nodiscard]] T* operator->() const
         {
             check(valid());
-            return _ptr.lock().get();
+            return _ptr;
         }
 
         [[nodiscard]] bool valid() const noexcept
         {
-            return !_ptr.expired();
+            return _block && !_block->expired();
         }
 
         weak_ptr& if_valid(const std::function<void(T&)>& func)
@@ -84,44 +135,98 @@ namespace peng
         }
 
     private:
-        std::weak_ptr<T> _ptr;
+        // Adopts a weak reference that has already been acquired on the block
+        weak_ptr(T* ptr, detail::ControlBlock* block) noexcept
+            : _ptr(ptr)
+            , _block(block)
+        { }
+
+        [[nodiscard]] weak_ptr&& acquired() && noexcept
+        {
+            acquire();
+            return std::move(*this);
+        }
+
+        // Null if the object has expired, without acquiring a strong reference
+        [[nodiscard]] T* live_ptr() const noexcept
+        {
+            return valid() ? _ptr : nullptr;
+        }
+
+        void acquire() const noexcept
+        {
+            if (_block)
+            {
+                _block->add_weak();
+            }
+        }
+
+        void release() noexcept
+        {
+            if (_block)
+            {
+                _block->release_weak();
+            }
+        }
+
+        void swap(weak_ptr& other) noexcept
+        {
+            std::swap(_ptr, other._ptr);
+            std::swap(_block, other._block);
+        }
+
+        T* _ptr;
+        detail::ControlBlock* _block;
     };
 
+    template <typename T, typename U>
+    [[nodiscard]] weak_ptr<T> static_pointer_cast(const weak_ptr<U>& ptr) noexcept
+    {
+        detail::ControlBlock* block = detail::PtrAccess::block(ptr);
+        if (!block)
+        {
+            return {};
+        }
+
+        block->add_weak();
+        return detail::PtrAccess::adopt<weak_ptr<T>>(static_cast<T*>(detail::PtrAccess::raw(ptr)), block);
+    }
+
 #pragma region Comparison Operators
 
     template <typename T, typename U>
     requires std::equality_comparable_with<T*, U*>
     [[nodiscard]] bool operator==(const weak_ptr<T>& a, const weak_ptr<U>& b)
     {
-        return a.lock().get() == b.lock().get();
+        return detail::PtrAccess::live(a) == detail::PtrAccess::live(b);
     }
 
     template <typename T, typename U>
     requires std::equality_comparable_with<T*, U*>
     [[nodiscard]] bool operator==(const weak_ptr<T>& a, const shared_ptr<U>& b)
     {
-        return a == weak_ptr<T>(b);
+        return detail::PtrAccess::live(a) == b.get();
     }
 
     template <typename T, typename U>
     requires std::equality_comparable_with<T*, U*>
     [[nodiscard]] bool operator==(const shared_ptr<T>& a, const weak_ptr<U>& b)
     {
-        return weak_ptr<T>(a) == b;
+        return a.get() == detail::PtrAccess::live(b);
     }
 
     template <typename T, typename U>
     requires std::equality_comparable_with<T*, U*>
     [[nodiscard]] bool operator==(const weak_ptr<T>& a, const shared_ref<U>& b)
     {
-        return a == weak_ptr<T>(b);
+        return detail::PtrAccess::live(a) == b.get();
     }
 
     template <typename T, typename U>
     requires std::equality_comparable_with<T*, U*>
     [[nodiscard]] bool operator==(const shared_ref<T>& a, const weak_ptr<U>& b)
     {
-        return weak_ptr<T>(a) == b;
+        return a.get() == detail::PtrAccess::live(b);
     }
 
 #pragma endregion
@@ -132,6 +237,6 @@ struct std::hash<peng::weak_ptr<T>>
 {
     size_t operator()(const peng::weak_ptr<T>& ptr) const
     {
-        return std::hash<T*>{}(ptr.lock().get());
+        return std::hash<T*>{}(peng::detail::PtrAccess::live(ptr));
     }
 };
\ No newline at end of file
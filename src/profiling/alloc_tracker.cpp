@@ -0,0 +1,468 @@
+#ifndef NO_PROFILING
+
+#include "alloc_tracker.h"
+
+#include <new>
+#include <atomic>
+#include <ranges>
+#include <cstdlib>
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#include "counter.h"
+
+using namespace profiling;
+
+namespace
+{
+    constexpr int32_t max_threads = 64;
+    constexpr int32_t max_scope_depth = 32;
+    constexpr int32_t scopes_per_thread = 256;
+
+    constexpr const char* unscoped = "(unscoped)";
+    constexpr const char* unattributed = "(unattributed)";
+
+    std::atomic<bool> tracking_enabled = false;
+
+    // Each counter only ever has a single writer, so it can be bumped without a locked instruction
+    void bump(std::atomic<uint64_t>& counter, uint64_t amount) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Counts are monotonic, the reported values are only touched by end_frame and let it compute per frame deltas
+    struct ScopeCounter
+    {
+        std::atomic<const char*> scope = nullptr;
+        std::atomic<uint64_t> count = 0;
+        std::atomic<uint64_t> bytes = 0;
+
+        uint64_t reported_count = 0;
+        uint64_t reported_bytes = 0;
+
+        void reset() noexcept
+        {
+            scope.store(nullptr, std::memory_order_relaxed);
+            count.store(0, std::memory_order_relaxed);
+            bytes.store(0, std::memory_order_relaxed);
+            reported_count = 0;
+            reported_bytes = 0;
+        }
+    };
+
+    enum class SlotState : uint8_t
+    {
+        free,
+        in_use,
+        retired
+    };
+
+    // Counters owned by a single thread, but readable from the main thread at the end of every frame
+    // Slots live in static storage so that claiming one never needs to allocate from inside the hook
+    struct ThreadSlot
+    {
+        std::atomic<SlotState> state = SlotState::free;
+        ScopeCounter total;
+        ScopeCounter scopes[scopes_per_thread];
+
+        ScopeCounter* find_scope(const char* scope) noexcept
+        {
+            const uintptr_t hash = (reinterpret_cast<uintptr_t>(scope) >> 3) * 0x9E3779B97F4A7C15ull;
+            for (int32_t probe = 0; probe < scopes_per_thread; probe++)
+            {
+                ScopeCounter& counter = scopes[(hash + probe) % scopes_per_thread];
+                const char* existing = counter.scope.load(std::memory_order_relaxed);
+
+                if (existing == scope)
+                {
+                    return &counter;
+                }
+
+                if (!existing)
+                {
+                    counter.scope.store(scope, std::memory_order_release);
+                    return &counter;
+                }
+            }
+
+            // Any allocations that don't fit in the table are reported as unattributed
+            return nullptr;
+        }
+
+        void reset() noexcept
+        {
+            total.reset();
+            for (ScopeCounter& counter : scopes)
+            {
+                counter.reset();
+            }
+        }
+    };
+
+    ThreadSlot thread_slots[max_threads];
+
+    // Trivially initialized so that touching it from inside operator new is always safe
+    // The slot is handed back to end_frame once the thread exits
+    struct ThreadState
+    {
+        constexpr ThreadState() noexcept = default;
+
+        ~ThreadState()
+        {
+            if (slot)
+            {
+                slot->state.store(SlotState::retired, std::memory_order_release);
+            }
+
+            // Allocations made by destructors of later thread locals must not touch the retired slot
+            slot = nullptr;
+            claim_failed = true;
+        }
+
+        ThreadSlot* slot = nullptr;
+        bool claim_failed = false;
+
+        // Stops the thread's own bookkeeping from being counted
+        int32_t suspended = 0;
+
+        int32_t depth = 0;
+        const char* scopes[max_scope_depth] = {};
+    };
+
+    constinit thread_local ThreadState thread_state;
+
+    ThreadSlot* claim_slot(ThreadState& state) noexcept
+    {
+        for (ThreadSlot& slot : thread_slots)
+        {
+            SlotState expected = SlotState::free;
+            if (slot.state.compare_exchange_strong(expected, SlotState::in_use, std::memory_order_acquire))
+            {
+                state.slot = &slot;
+                return &slot;
+            }
+        }
+
+        // Threads beyond the limit go uncounted rather than retrying on every allocation
+        state.claim_failed = true;
+        return nullptr;
+    }
+
+    void record_allocation(size_t size) noexcept
+    {
+        if (!tracking_enabled.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        ThreadState& state = thread_state;
+        if (state.suspended > 0 || state.claim_failed)
+        {
+            return;
+        }
+
+        ThreadSlot* slot = state.slot ? state.slot : claim_slot(state);
+        if (!slot)
+        {
+            return;
+        }
+
+        bump(slot->total.count, 1);
+        bump(slot->total.bytes, size);
+
+        // Scopes nested deeper than the stack are attributed to the deepest scope recorded
+        const int32_t depth = std::min(state.depth, max_scope_depth);
+        const char* scope = depth > 0 ? state.scopes[depth - 1] : unscoped;
+
+        if (ScopeCounter* counter = slot->find_scope(scope))
+        {
+            bump(counter->count, 1);
+            bump(counter->bytes, size);
+        }
+    }
+
+    // Returns the allocations made since the last call and marks it as reported
+    ScopeAllocations take_delta(ScopeCounter& counter, const char* scope) noexcept
+    {
+        const uint64_t count = counter.count.load(std::memory_order_relaxed);
+        const uint64_t bytes = counter.bytes.load(std::memory_order_relaxed);
+
+        const ScopeAllocations delta = {
+            .scope = scope,
+            .count = count - counter.reported_count,
+            .bytes = bytes - counter.reported_bytes
+        };
+
+        counter.reported_count = count;
+        counter.reported_bytes = bytes;
+
+        return delta;
+    }
+
+    struct SuspendTracking
+    {
+        SuspendTracking() noexcept { thread_state.suspended++; }
+        ~SuspendTracking() { thread_state.suspended--; }
+    };
+
+    void* allocate(size_t size)
+    {
+        record_allocation(size);
+
+        void* ptr = std::malloc(size > 0 ? size : 1);
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return ptr;
+    }
+
+    void* allocate_aligned(size_t size, std::align_val_t alignment)
+    {
+        record_allocation(size);
+
+        const size_t align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+        void* ptr = _aligned_malloc(size > 0 ? size : 1, align);
+#else
+        void* ptr = std::aligned_alloc(align, std::max((size + align - 1) & ~(align - 1), align));
+#endif
+
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+
+        return ptr;
+    }
+
+    void deallocate_aligned(void* ptr) noexcept
+    {
+#ifdef _MSC_VER
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+void AllocTracker::set_enabled(bool enabled)
+{
+    if (enabled && !this->enabled())
+    {
+        discard_pending();
+
+        _frames_tracked = 0;
+        _frames_over_budget = 0;
+        _last_frame = {};
+        _worst_frame = {};
+    }
+
+    tracking_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void AllocTracker::set_frame_budget(uint64_t max_allocations, int32_t warmup_frames)
+{
+    _max_allocations = max_allocations;
+    _warmup_frames = warmup_frames;
+}
+
+void AllocTracker::clear_frame_budget()
+{
+    set_frame_budget(std::numeric_limits<uint64_t>::max(), 0);
+}
+
+const FrameAllocations& AllocTracker::end_frame()
+{
+    SuspendTracking suspend;
+
+    if (!enabled())
+    {
+        return _last_frame;
+    }
+
+    _last_frame.count = 0;
+    _last_frame.bytes = 0;
+    _last_frame.scopes.clear();
+    _scope_totals.clear();
+
+    for (ThreadSlot& slot : thread_slots)
+    {
+        const SlotState state = slot.state.load(std::memory_order_acquire);
+        if (state == SlotState::free)
+        {
+            continue;
+        }
+
+        const ScopeAllocations total = take_delta(slot.total, nullptr);
+        _last_frame.count += total.count;
+        _last_frame.bytes += total.bytes;
+
+        for (ScopeCounter& counter : slot.scopes)
+        {
+            const char* scope = counter.scope.load(std::memory_order_acquire);
+            if (!scope)
+            {
+                continue;
+            }
+
+            const ScopeAllocations delta = take_delta(counter, scope);
+            if (delta.count > 0)
+            {
+                ScopeAllocations& scope_total = _scope_totals.try_emplace(scope, ScopeAllocations{ scope, 0, 0 }).first->second;
+                scope_total.count += delta.count;
+                scope_total.bytes += delta.bytes;
+            }
+        }
+
+        // Everything the exited thread counted has been reported, so the slot can be reused
+        if (state == SlotState::retired)
+        {
+            slot.reset();
+            slot.state.store(SlotState::free, std::memory_order_release);
+        }
+    }
+
+    uint64_t attributed_count = 0;
+    uint64_t attributed_bytes = 0;
+
+    for (const ScopeAllocations& scope : _scope_totals | std::views::values)
+    {
+        _last_frame.scopes.push_back(scope);
+        attributed_count += scope.count;
+        attributed_bytes += scope.bytes;
+    }
+
+    if (attributed_count < _last_frame.count)
+    {
+        _last_frame.scopes.push_back({ unattributed, _last_frame.count - attributed_count, _last_frame.bytes - attributed_bytes });
+    }
+
+    std::ranges::sort(_last_frame.scopes, std::ranges::greater(), &ScopeAllocations::count);
+
+    _frames_tracked++;
+    _last_frame.over_budget = _frames_tracked > _warmup_frames && _last_frame.count > _max_allocations;
+
+    if (_last_frame.over_budget)
+    {
+        _frames_over_budget++;
+    }
+
+    if (_frames_tracked > _warmup_frames && _last_frame.count > _worst_frame.count)
+    {
+        _worst_frame = _last_frame;
+    }
+
+    SET_COUNTER("AllocTracker - allocations", _last_frame.count);
+    SET_COUNTER("AllocTracker - bytes", _last_frame.bytes);
+
+    return _last_frame;
+}
+
+bool AllocTracker::enabled() const noexcept
+{
+    return tracking_enabled.load(std::memory_order_relaxed);
+}
+
+const FrameAllocations& AllocTracker::last_frame() const noexcept
+{
+    return _last_frame;
+}
+
+const FrameAllocations& AllocTracker::worst_frame() const noexcept
+{
+    return _worst_frame;
+}
+
+int32_t AllocTracker::frames_tracked() const noexcept
+{
+    return _frames_tracked;
+}
+
+int32_t AllocTracker::frames_over_budget() const noexcept
+{
+    return _frames_over_budget;
+}
+
+void AllocTracker::push_scope(const char* scope) noexcept
+{
+    ThreadState& state = thread_state;
+    if (state.depth < max_scope_depth)
+    {
+        state.scopes[state.depth] = scope;
+    }
+
+    state.depth++;
+}
+
+void AllocTracker::pop_scope() noexcept
+{
+    thread_state.depth--;
+}
+
+void AllocTracker::discard_pending()
+{
+    for (ThreadSlot& slot : thread_slots)
+    {
+        if (slot.state.load(std::memory_order_acquire) == SlotState::free)
+        {
+            continue;
+        }
+
+        take_delta(slot.total, nullptr);
+        for (ScopeCounter& counter : slot.scopes)
+        {
+            take_delta(counter, nullptr);
+        }
+    }
+}
+
+#pragma region Global Allocation Hooks
+
+void* operator new(size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+    return allocate(size);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return allocate_aligned(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    deallocate_aligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    deallocate_aligned(ptr);
+}
+
+#pragma endregion
+
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+#ifndef NO_PROFILING
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+#include <utils/singleton.h>
+
+namespace profiling
+{
+    struct ScopeAllocations
+    {
+        const char* scope;
+        uint64_t count;
+        uint64_t bytes;
+    };
+
+    struct FrameAllocations
+    {
+        uint64_t count = 0;
+        uint64_t bytes = 0;
+        bool over_budget = false;
+
+        // Allocations made directly within each scope, highest count first
+        std::vector<ScopeAllocations> scopes;
+    };
+
+    // Diagnostics mode that counts every allocation made through the global operator new
+    // Allocations are counted per thread and attributed to the innermost SCOPED_EVENT open on that thread,
+    // then gathered into a per frame report. While disabled the hooks cost a single relaxed load
+    class AllocTracker : public utils::Singleton<AllocTracker>
+    {
+        using Singleton::Singleton;
+
+    public:
+        void set_enabled(bool enabled);
+
+        // Once the warmup frames have passed, any frame making more than max_allocations is flagged as over budget
+        // A steady state frame is expected to make no allocations, so a budget of 0 verifies exactly that
+        void set_frame_budget(uint64_t max_allocations, int32_t warmup_frames);
+        void clear_frame_budget();
+
+        // Gathers every allocation made across all threads since the previous call
+        // Should be called once at the end of each frame from the main thread
+        const FrameAllocations& end_frame();
+
+        [[nodiscard]] bool enabled() const noexcept;
+        [[nodiscard]] const FrameAllocations& last_frame() const noexcept;
+        [[nodiscard]] const FrameAllocations& worst_frame() const noexcept;
+        [[nodiscard]] int32_t frames_tracked() const noexcept;
+        [[nodiscard]] int32_t frames_over_budget() const noexcept;
+
+        // Maintained by ScopedEvent so allocations can be attributed to the current scope
+        static void push_scope(const char* scope) noexcept;
+        static void pop_scope() noexcept;
+
+    private:
+        // Marks everything counted so far as reported so it is not attributed to the next frame
+        void discard_pending();
+
+        uint64_t _max_allocations = std::numeric_limits<uint64_t>::max();
+        int32_t _warmup_frames = 0;
+        int32_t _frames_tracked = 0;
+        int32_t _frames_over_budget = 0;
+
+        FrameAllocations _last_frame;
+        FrameAllocations _worst_frame;
+        std::unordered_map<const char*, ScopeAllocations> _scope_totals;
+    };
+}
+
+#endif
\ No newline at end of file
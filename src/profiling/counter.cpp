@@ -0,0 +1,12 @@
+#ifndef NO_PROFILING
+
+#include "counter.h"
+
+#include "profiler_manager.h"
+
+void profiling::set_counter(const char* id, int64_t value)
+{
+    ProfilerManager::get().current_profiler()->set_counter(id, value);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#ifndef NO_PROFILING
+
+#include <cstdint>
+
+namespace profiling
+{
+    void set_counter(const char* id, int64_t value);
+}
+
+// Reports the current value of a named counter to external profilers
+//
+// Usage: SET_COUNTER(id, value);
+//  - The 'id' must outlive the call, prefer string literals or persistent strings
+//  - Counters are sampled at the point of the call, so should be set once per frame
+#define SET_COUNTER(id, value) profiling::set_counter(id, static_cast<int64_t>(value))
+
+#else
+
+#define SET_COUNTER(id, value) ((void)0)
+
+#endif
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include "event_data.h"
 
 namespace profiling
@@ -11,5 +13,6 @@ namespace profiling
 
         virtual void begin_event(const EventData& event) = 0;
         virtual void end_event() = 0;
+        virtual void set_counter(const char* id, int64_t value) = 0;
     };
 }
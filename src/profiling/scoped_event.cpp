@@ -3,17 +3,20 @@
 #include "scoped_event.h"
 
 #include "profiler_manager.h"
+#include "alloc_tracker.h"
 
 using namespace profiling;
 
 ScopedEvent::ScopedEvent(const EventData& event_data)
 {
+    AllocTracker::push_scope(event_data.id);
     ProfilerManager::get().current_profiler()->begin_event(event_data);
 }
 
 ScopedEvent::~ScopedEvent()
 {
     ProfilerManager::get().current_profiler()->end_event();
+    AllocTracker::pop_scope();
 }
 
 #endif
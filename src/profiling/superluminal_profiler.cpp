@@ -52,3 +52,8 @@ void SuperluminalProfiler::end_event()
         _functions.EndEvent();
     }
 }
+
+void SuperluminalProfiler::set_counter([[maybe_unused]] const char* id, [[maybe_unused]] int64_t value)
+{
+    // Superluminal has no counter API, counters are only reported by profilers that support them
+}
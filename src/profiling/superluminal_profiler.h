@@ -18,6 +18,7 @@ namespace profiling
 
         void begin_event(const EventData& event) override;
         void end_event() override;
+        void set_counter(const char* id, int64_t value) override;
 
     private:
         // void* so we can avoid including windows.h in the header
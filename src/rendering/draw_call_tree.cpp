@@ -13,18 +13,17 @@
 
 using namespace rendering;
 
-DrawCallTree::DrawCallTree(std::vector<DrawCall>&& draw_calls)
+DrawCallTree::DrawCallTree(std::vector<DrawCall>& draw_calls)
 {
     SCOPED_EVENT("Building DrawCallTree", strtools::catf_temp("%d draw calls", draw_calls.size()));
 
-    std::vector<DrawCall> draw_calls_ordered(std::move(draw_calls));
-    std::ranges::sort(draw_calls_ordered,
+    std::ranges::sort(draw_calls,
         [](const DrawCall& x, const DrawCall& y)
         {
             return x.order < y.order;
         });
 
-    for (DrawCall& draw_call : draw_calls_ordered)
+    for (DrawCall& draw_call : draw_calls)
     {
         check(draw_call.material);
         check(draw_call.mesh);
@@ -39,6 +38,8 @@ DrawCallTree::DrawCallTree(std::vector<DrawCall>&& draw_calls)
         }
     }
 
+    draw_calls.clear();
+
     std::ranges::sort(
         _shader_draws,
         [](const ShaderDrawTree& x, const ShaderDrawTree& y)
@@ -56,7 +57,7 @@ void DrawCallTree::execute(RenderQueueStats& stats) const
 
     for (const ShaderDrawTree& shader_draw : _shader_draws)
     {
-        const peng::shared_ref<const Shader> shader = shader_draw.shader;
+        const peng::borrowed_ptr<const Shader> shader = shader_draw.shader;
 
         SCOPED_GPU_EVENT(strtools::catf_temp("Shader - %s", shader->name().c_str()));
         shader_draw.shader->use();
@@ -64,7 +65,7 @@ void DrawCallTree::execute(RenderQueueStats& stats) const
 
         for (const MeshDrawTree& mesh_draw : shader_draw.mesh_draws)
         {
-            const peng::shared_ref<const Mesh> mesh = mesh_draw.mesh;
+            const peng::borrowed_ptr<const Mesh> mesh = mesh_draw.mesh;
 
             // TODO: we can skip a mesh switch if the mesh already happens to be bound
             //       from the previous shader draw
@@ -98,8 +99,7 @@ void DrawCallTree::execute(RenderQueueStats& stats) const
 
 void DrawCallTree::add_opaque_draw(DrawCall&& draw_call)
 {
-    const peng::shared_ref<const Shader> shader = draw_call.material->shader();
-    MeshDrawTree& mesh_draw = find_add_mesh_draw(shader, draw_call.mesh.to_shared_ref());
+    MeshDrawTree& mesh_draw = find_add_mesh_draw(draw_call.material->shader(), draw_call.mesh);
     mesh_draw.draw_calls.push_back(std::move(draw_call));
 }
 
@@ -118,7 +118,7 @@ void DrawCallTree::add_blended_draw(DrawCall&& draw_call)
     if (!mesh_draw || mesh_draw->mesh != draw_call.mesh)
     {
         mesh_draw = &shader_draw->mesh_draws.emplace_back(MeshDrawTree{
-            .mesh = draw_call.mesh.to_shared_ref()
+            .mesh = draw_call.mesh
         });
     }
 
@@ -136,9 +136,9 @@ void DrawCallTree::merge_tree()
     }
 }
 
-std::vector<ShaderDrawTree> DrawCallTree::merge_shader_draws(std::vector<ShaderDrawTree>&& shader_draws) const
+memory::frame_vector<ShaderDrawTree> DrawCallTree::merge_shader_draws(memory::frame_vector<ShaderDrawTree>&& shader_draws) const
 {
-    std::vector<ShaderDrawTree> merged_draws;
+    memory::frame_vector<ShaderDrawTree> merged_draws;
 
     for (ShaderDrawTree& shader_draw : shader_draws)
     {
@@ -156,9 +156,9 @@ std::vector<ShaderDrawTree> DrawCallTree::merge_shader_draws(std::vector<ShaderD
     return merged_draws;
 }
 
-std::vector<MeshDrawTree> DrawCallTree::merge_mesh_draws(std::vector<MeshDrawTree>&& mesh_draws) const
+memory::frame_vector<MeshDrawTree> DrawCallTree::merge_mesh_draws(memory::frame_vector<MeshDrawTree>&& mesh_draws) const
 {
-    std::vector<MeshDrawTree> merged_draws;
+    memory::frame_vector<MeshDrawTree> merged_draws;
 
     for (MeshDrawTree& mesh_draw : mesh_draws)
     {
@@ -176,7 +176,7 @@ std::vector<MeshDrawTree> DrawCallTree::merge_mesh_draws(std::vector<MeshDrawTre
     return merged_draws;
 }
 
-ShaderDrawTree& DrawCallTree::find_add_shader_draw(const peng::shared_ref<const Shader>& shader)
+ShaderDrawTree& DrawCallTree::find_add_shader_draw(peng::borrowed_ptr<const Shader> shader)
 {
     if (const auto it = _shader_draw_indices.find(shader); it != _shader_draw_indices.end())
     {
@@ -194,8 +194,8 @@ ShaderDrawTree& DrawCallTree::find_add_shader_draw(const peng::shared_ref<const
     return _shader_draws[shader_draw.index];
 }
 
-MeshDrawTree& DrawCallTree::find_add_mesh_draw(const peng::shared_ref<const Shader>& shader,
-    const peng::shared_ref<const Mesh>& mesh)
+MeshDrawTree& DrawCallTree::find_add_mesh_draw(peng::borrowed_ptr<const Shader> shader,
+    peng::borrowed_ptr<const Mesh> mesh)
 {
     const auto key = std::make_tuple(shader, mesh);
     if (const auto it = _mesh_draw_indices.find(key); it != _mesh_draw_indices.end())
@@ -205,7 +205,7 @@ MeshDrawTree& DrawCallTree::find_add_mesh_draw(const peng::shared_ref<const Shad
     }
 
     ShaderDrawTree& shader_draw = find_add_shader_draw(shader);
-    std::vector<MeshDrawTree>& mesh_draws = shader_draw.mesh_draws;
+    memory::frame_vector<MeshDrawTree>& mesh_draws = shader_draw.mesh_draws;
 
     const MeshDrawTree mesh_draw = {
         .index = mesh_draws.size(),
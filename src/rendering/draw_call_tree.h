@@ -1,9 +1,9 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
 
-#include <memory/shared_ref.h>
+#include <memory/borrowed_ptr.h>
+#include <memory/frame_allocator.h>
 #include <utils/hash_helpers.h>
 
 #include "draw_call.h"
@@ -17,27 +17,30 @@ namespace rendering
 
     // Draw calls aggregated by the mesh, only differing in the uniforms applied
     // It is illegal for the materials to use different underlying shaders
+    // The tree only borrows meshes and shaders since its draw calls keep them alive
     struct MeshDrawTree
     {
         size_t index;
-        peng::shared_ref<const Mesh> mesh;
-        std::vector<DrawCall> draw_calls;
+        peng::borrowed_ptr<const Mesh> mesh;
+        memory::frame_vector<DrawCall> draw_calls;
     };
 
     // Draw calls aggregated by the shader. Each draw may differ by mesh and uniforms
     struct ShaderDrawTree
     {
         size_t index;
-        peng::shared_ref<const Shader> shader;
-        std::vector<MeshDrawTree> mesh_draws;
+        peng::borrowed_ptr<const Shader> shader;
+        memory::frame_vector<MeshDrawTree> mesh_draws;
     };
 
     // Tree of draw calls aggregated by shader, then mesh, the uniforms
     // This allows all draw calls to be executed with minimal state switches
+    // The tree is rebuilt every frame, so it lives entirely in the frame arena
     class DrawCallTree
     {
     public:
-        explicit DrawCallTree(std::vector<DrawCall>&& draw_calls);
+        // Moves the draw calls into the tree, leaving the source vector empty but with its capacity intact
+        explicit DrawCallTree(std::vector<DrawCall>& draw_calls);
 
         void execute(RenderQueueStats& stats) const;
 
@@ -52,26 +55,26 @@ namespace rendering
         void merge_tree();
 
         // Merges adjacent shader draws in the tree
-        std::vector<ShaderDrawTree> merge_shader_draws(std::vector<ShaderDrawTree>&& shader_draws) const;
+        memory::frame_vector<ShaderDrawTree> merge_shader_draws(memory::frame_vector<ShaderDrawTree>&& shader_draws) const;
 
         // Merges adjacent mesh draws in the tree
-        std::vector<MeshDrawTree> merge_mesh_draws(std::vector<MeshDrawTree>&& mesh_draws) const;
+        memory::frame_vector<MeshDrawTree> merge_mesh_draws(memory::frame_vector<MeshDrawTree>&& mesh_draws) const;
 
-        ShaderDrawTree& find_add_shader_draw(const peng::shared_ref<const Shader>& shader);
+        ShaderDrawTree& find_add_shader_draw(peng::borrowed_ptr<const Shader> shader);
 
         MeshDrawTree& find_add_mesh_draw(
-            const peng::shared_ref<const Shader>& shader,
-            const peng::shared_ref<const Mesh>& mesh
+            peng::borrowed_ptr<const Shader> shader,
+            peng::borrowed_ptr<const Mesh> mesh
         );
 
-        std::vector<ShaderDrawTree> _shader_draws;
-        std::unordered_map<peng::shared_ref<const Shader>, size_t> _shader_draw_indices;
+        memory::frame_vector<ShaderDrawTree> _shader_draws;
+        memory::frame_unordered_map<peng::borrowed_ptr<const Shader>, size_t> _shader_draw_indices;
 
         // Maps from a (shader, mesh) key to a (shader_draw index, mesh_draw sub index) value
-        std::unordered_map<
+        memory::frame_unordered_map<
             std::tuple<
-            peng::shared_ref<const Shader>,
-            peng::shared_ref<const Mesh>
+            peng::borrowed_ptr<const Shader>,
+            peng::borrowed_ptr<const Mesh>
             >,
             std::tuple<size_t, size_t>
         > _mesh_draw_indices;
@@ -4,6 +4,7 @@
 #include <profiling/scoped_event.h>
 
 #include "texture.h"
+#include "gpu_deletion_queue.h"
 
 using namespace rendering;
 
@@ -25,7 +26,7 @@ FrameBuffer::~FrameBuffer()
 
     // TODO: if framebuffer is currently bound we should unbind before destroying it
 
-    glDeleteFramebuffers(1, &_fbo);
+    GpuDeletionQueue::get().retire(GpuResourceType::framebuffer, _fbo);
 }
 
 void FrameBuffer::add_color_attachment()
@@ -0,0 +1,116 @@
+#include "gpu_deletion_queue.h"
+
+#include <chrono>
+
+#include <profiling/counter.h>
+#include <profiling/scoped_event.h>
+#include <utils/strtools.h>
+
+using namespace rendering;
+
+namespace
+{
+    constexpr size_t batch_size = 256;
+}
+
+GpuDeletionQueue::GpuDeletionQueue()
+    : _retired_consumer(_retired)
+    , _batch(batch_size)
+    , _budget(0.5f)
+{ }
+
+void GpuDeletionQueue::retire(GpuResourceType type, GLuint handle)
+{
+    if (handle)
+    {
+        _retired.enqueue(GpuResource{
+            .type = type,
+            .handle = handle
+        });
+    }
+}
+
+void GpuDeletionQueue::flush()
+{
+    flush(_budget);
+}
+
+void GpuDeletionQueue::flush_all()
+{
+    flush(0);
+}
+
+void GpuDeletionQueue::set_budget(float budget_ms) noexcept
+{
+    _budget = budget_ms;
+}
+
+float GpuDeletionQueue::budget() const noexcept
+{
+    return _budget;
+}
+
+void GpuDeletionQueue::flush(float budget_ms)
+{
+    SCOPED_EVENT("GpuDeletionQueue - flush");
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<float, std::milli>(budget_ms);
+
+    size_t num_deleted = 0;
+    while (const size_t count = _retired.try_dequeue_bulk(_retired_consumer, _batch.begin(), batch_size))
+    {
+        delete_batch(count);
+        num_deleted += count;
+
+        if (budget_ms > 0 && std::chrono::steady_clock::now() - start >= budget)
+        {
+            break;
+        }
+    }
+
+    SET_COUNTER("GpuDeletionQueue - deleted", num_deleted);
+}
+
+void GpuDeletionQueue::delete_batch(size_t count)
+{
+    SCOPED_EVENT("GpuDeletionQueue - delete batch", strtools::catf_temp("%d objects", count));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const GpuResource& resource = _batch[i];
+        switch (resource.type)
+        {
+            case GpuResourceType::texture:      _textures.push_back(resource.handle); break;
+            case GpuResourceType::buffer:       _buffers.push_back(resource.handle); break;
+            case GpuResourceType::vertex_array: _vertex_arrays.push_back(resource.handle); break;
+            case GpuResourceType::framebuffer:  _framebuffers.push_back(resource.handle); break;
+            case GpuResourceType::program:      glDeleteProgram(resource.handle); break;
+        }
+    }
+
+    // Programs have no batched delete, everything else is freed with a single call per type
+    if (!_textures.empty())
+    {
+        glDeleteTextures(static_cast<GLsizei>(_textures.size()), _textures.data());
+        _textures.clear();
+    }
+
+    if (!_buffers.empty())
+    {
+        glDeleteBuffers(static_cast<GLsizei>(_buffers.size()), _buffers.data());
+        _buffers.clear();
+    }
+
+    if (!_vertex_arrays.empty())
+    {
+        glDeleteVertexArrays(static_cast<GLsizei>(_vertex_arrays.size()), _vertex_arrays.data());
+        _vertex_arrays.clear();
+    }
+
+    if (!_framebuffers.empty())
+    {
+        glDeleteFramebuffers(static_cast<GLsizei>(_framebuffers.size()), _framebuffers.data());
+        _framebuffers.clear();
+    }
+}
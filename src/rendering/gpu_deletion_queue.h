@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+
+#include <GL/glew.h>
+#include <common/common.h>
+#include <utils/singleton.h>
+
+namespace rendering
+{
+    enum class GpuResourceType : uint8_t
+    {
+        texture,
+        buffer,
+        vertex_array,
+        framebuffer,
+        program
+    };
+
+    struct GpuResource
+    {
+        GpuResourceType type = GpuResourceType::texture;
+        GLuint handle = 0;
+    };
+
+    // Defers destruction of GPU objects to a fixed point in the frame
+    // Resources can be retired from any thread, but are only deleted on the render thread during flush
+    class GpuDeletionQueue : public utils::Singleton<GpuDeletionQueue>
+    {
+        using Singleton::Singleton;
+
+    public:
+        GpuDeletionQueue();
+
+        // Enqueues a GPU object for deletion on the next flush, null handles are ignored
+        void retire(GpuResourceType type, GLuint handle);
+
+        // Deletes retired objects in batches until the queue is empty or the frame budget is spent
+        void flush();
+
+        // Deletes every retired object regardless of budget, must be called before the GL context is destroyed
+        void flush_all();
+
+        // Time spent deleting objects per flush, at least one batch is always deleted
+        // A budget of 0 deletes everything retired at once
+        void set_budget(float budget_ms) noexcept;
+        [[nodiscard]] float budget() const noexcept;
+
+    private:
+        void flush(float budget_ms);
+        void delete_batch(size_t count);
+
+        common::concurrent_queue<GpuResource> _retired;
+        moodycamel::ConsumerToken _retired_consumer;
+
+        std::vector<GpuResource> _batch;
+        std::vector<GLuint> _textures;
+        std::vector<GLuint> _buffers;
+        std::vector<GLuint> _vertex_arrays;
+        std::vector<GLuint> _framebuffers;
+
+        float _budget;
+    };
+}
@@ -123,7 +123,7 @@ void Material::bind_buffers()
     }
 }
 
-peng::shared_ref<const Shader> Material::shader() const
+const peng::shared_ref<const Shader>& Material::shader() const
 {
     return _shader;
 }
@@ -50,7 +50,7 @@ namespace rendering
         void set_buffer(GLint buffer_index, const peng::shared_ref<const IShaderBuffer>& buffer);
         void set_buffer(const std::string& buffer_name, const peng::shared_ref<const IShaderBuffer>& buffer);
 
-        [[nodiscard]] peng::shared_ref<const Shader> shader() const;
+        [[nodiscard]] const peng::shared_ref<const Shader>& shader() const;
 
     private:
         void set_parameter(GLint uniform_location, const Shader::Parameter& parameter);
@@ -9,6 +9,7 @@
 #include <profiling/scoped_event.h>
 
 #include "mesh_decoder.h"
+#include "gpu_deletion_queue.h"
 
 using namespace rendering;
 using namespace math;
@@ -68,9 +69,10 @@ Mesh::~Mesh()
     SCOPED_EVENT("Destroying mesh", _name.c_str());
     Logger::log("Destroying mesh '%s'", _name.c_str());
 
-    glDeleteBuffers(1, &_vbo);
-    glDeleteBuffers(1, &_ebo);
-    glDeleteVertexArrays(1, &_vao);
+    GpuDeletionQueue& deletion_queue = GpuDeletionQueue::get();
+    deletion_queue.retire(GpuResourceType::buffer, _vbo);
+    deletion_queue.retire(GpuResourceType::buffer, _ebo);
+    deletion_queue.retire(GpuResourceType::vertex_array, _vao);
 }
 
 peng::shared_ref<Mesh> Mesh::load_asset(const Archive& archive)
@@ -25,7 +25,7 @@ void RenderQueue::execute()
     _sprite_batcher.convert_draws(_sprite_draw_calls, _draw_calls);
     _sprite_draw_calls.clear();
 
-    const DrawCallTree tree(std::move(_draw_calls));
+    const DrawCallTree tree(_draw_calls);
     tree.execute(stats);
 
     // TODO: for some reason the texture binding cache breaks after pause if you don't clear it
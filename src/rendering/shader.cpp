@@ -10,6 +10,7 @@
 #include <profiling/scoped_event.h>
 
 #include "shader_compiler.h"
+#include "gpu_deletion_queue.h"
 #include "shader_buffer.h"
 #include "primitives.h"
 
@@ -122,7 +123,7 @@ Shader::~Shader()
     SCOPED_EVENT("Destroying shader", _name.c_str());
     Logger::log("Destroying shader '%s'", _name.c_str());
 
-    glDeleteProgram(_program);
+    GpuDeletionQueue::get().retire(GpuResourceType::program, _program);
 }
 
 peng::shared_ref<Shader> Shader::load_asset(const Archive& archive)
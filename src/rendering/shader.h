@@ -7,6 +7,7 @@
 
 #include <GL/glew.h>
 #include <memory/shared_ref.h>
+#include <memory/gc.h>
 #include <math/matrix3x3.h>
 #include <math/matrix4x4.h>
 
@@ -24,6 +25,10 @@ namespace rendering
     class Shader
     {
     public:
+        // Compiling and linking is expensive, so unused shaders stay revivable for a few seconds
+        // in case an entity spawned shortly afterwards loads them again
+        static constexpr memory::GCPolicy gc_policy = { .dead_frames = 300 };
+
         using Parameter = std::variant<
             int32_t,
             uint32_t,
@@ -42,7 +42,7 @@ peng::shared_ref<Sprite> Sprite::load_asset(const Archive& archive)
     return memory::GC::alloc<Sprite>(texture, px_per_unit, position, resolution);
 }
 
-peng::shared_ref<const Texture> Sprite::texture() const noexcept
+const peng::shared_ref<const Texture>& Sprite::texture() const noexcept
 {
     return _texture;
 }
@@ -24,7 +24,7 @@ namespace rendering
 
         static peng::shared_ref<Sprite> load_asset(const Archive& archive);
 
-        [[nodiscard]] peng::shared_ref<const Texture> texture() const noexcept;
+        [[nodiscard]] const peng::shared_ref<const Texture>& texture() const noexcept;
         [[nodiscard]] float px_per_unit() const noexcept;
         [[nodiscard]] const math::Vector2i& position() const;
         [[nodiscard]] const math::Vector2i& resolution() const;
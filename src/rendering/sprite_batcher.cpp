@@ -1,10 +1,13 @@
 #include "sprite_batcher.h"
 
+#include <bit>
+#include <span>
 #include <ranges>
-#include <execution>
+#include <algorithm>
 
 #include <profiling/scoped_event.h>
 #include <utils/strtools.h>
+#include <threading/job_system.h>
 
 #include "sprite.h"
 #include "texture.h"
@@ -34,6 +37,9 @@ void SpriteBatcher::convert_draws(
     sort_draws(_processed_draw_buffer);
     bin_draws(_processed_draw_buffer, _draw_bin_buffer);
     emit_draws(_draw_bin_buffer, draws_out);
+
+    // Bins hold frame arena memory, so they must not survive past the end of the frame
+    _draw_bin_buffer.clear();
 }
 
 void SpriteBatcher::flush()
@@ -52,6 +58,7 @@ void SpriteBatcher::DrawBin::add_draw(const ProcessedSpriteDraw& processed_draw,
     if (_instance_data.empty())
     {
         key = bin_key;
+        _sprite = processed_draw.sprite;
         _depth_range = Vector2f(processed_draw.z_depth, processed_draw.z_depth);
     }
     else
@@ -62,11 +69,16 @@ void SpriteBatcher::DrawBin::add_draw(const ProcessedSpriteDraw& processed_draw,
     _instance_data.push_back(processed_draw.instance_data);
 }
 
-const std::vector<SpriteBatcher::SpriteInstanceData>& SpriteBatcher::DrawBin::instance_data() const noexcept
+const memory::frame_vector<SpriteBatcher::SpriteInstanceData>& SpriteBatcher::DrawBin::instance_data() const noexcept
 {
     return _instance_data;
 }
 
+const peng::shared_ref<const Texture>& SpriteBatcher::DrawBin::texture() const
+{
+    return _sprite->texture();
+}
+
 float SpriteBatcher::DrawBin::avg_depth() const noexcept
 {
     return (_depth_range.x + _depth_range.y) / 2;
@@ -94,12 +106,23 @@ void SpriteBatcher::preprocess_draws(
 ) const
 {
     SCOPED_EVENT("SpriteBatcher - preprocess draws");
-    processed_draws_out.clear();
-    processed_draws_out.reserve(sprite_draws_in.size());
+    processed_draws_out.resize(sprite_draws_in.size());
 
-    for (const SpriteDrawCall& sprite_draw : sprite_draws_in)
+    auto process = [&](size_t index)
+    {
+        processed_draws_out[index] = preprocess_draw(sprite_draws_in[index]);
+    };
+
+    if (sprite_draws_in.size() >= parallel_threshold)
+    {
+        threading::JobSystem::get().parallel_for(sprite_draws_in.size(), parallel_batch_size, process);
+    }
+    else
     {
-        processed_draws_out.push_back(preprocess_draw(sprite_draw));
+        for (size_t index = 0; index < sprite_draws_in.size(); index++)
+        {
+            process(index);
+        }
     }
 }
 
@@ -107,11 +130,59 @@ void SpriteBatcher::sort_draws(std::vector<ProcessedSpriteDraw>& processed_draws
 {
     SCOPED_EVENT("SpriteBatcher - sort draws");
 
-    std::sort(std::execution::par_unseq, processed_draws_in_out.begin(), processed_draws_in_out.end(),
-        [](const ProcessedSpriteDraw& x, const ProcessedSpriteDraw& y)
+    auto by_depth = [](const ProcessedSpriteDraw& x, const ProcessedSpriteDraw& y)
+    {
+        return x.z_depth < y.z_depth;
+    };
+
+    const size_t num_draws = processed_draws_in_out.size();
+    if (num_draws < parallel_threshold)
+    {
+        std::sort(processed_draws_in_out.begin(), processed_draws_in_out.end(), by_depth);
+        return;
+    }
+
+    // Sorts one run per thread in parallel, then merges pairs of runs until only a single run is left
+    threading::JobSystem& job_system = threading::JobSystem::get();
+    const size_t num_runs = std::bit_ceil(job_system.num_threads());
+    const size_t run_size = (num_draws + num_runs - 1) / num_runs;
+
+    auto run_start = [=](size_t run)
+    {
+        return std::min(run * run_size, num_draws);
+    };
+
+    std::span<ProcessedSpriteDraw> source = processed_draws_in_out;
+    job_system.parallel_for(num_runs, 1, [&](size_t run)
+    {
+        std::sort(source.begin() + run_start(run), source.begin() + run_start(run + 1), by_depth);
+    });
+
+    memory::frame_vector<ProcessedSpriteDraw> merge_buffer(num_draws);
+    std::span<ProcessedSpriteDraw> destination = merge_buffer;
+
+    for (size_t width = 1; width < num_runs; width *= 2)
+    {
+        job_system.parallel_for(num_runs / (width * 2), 1, [&](size_t pair)
         {
-            return x.z_depth < y.z_depth;
+            const size_t begin = run_start(pair * width * 2);
+            const size_t middle = run_start(pair * width * 2 + width);
+            const size_t end = run_start((pair + 1) * width * 2);
+
+            std::merge(
+                source.begin() + begin, source.begin() + middle,
+                source.begin() + middle, source.begin() + end,
+                destination.begin() + begin, by_depth
+            );
         });
+
+        std::swap(source, destination);
+    }
+
+    if (source.data() != processed_draws_in_out.data())
+    {
+        std::ranges::copy(source, processed_draws_in_out.begin());
+    }
 }
 
 void SpriteBatcher::bin_draws(
@@ -128,16 +199,16 @@ void SpriteBatcher::bin_draws(
     // To do this, we only allow 2 scenarios for incomplete alpha bins at any given time:
     // 1. A single bin of any depth range
     // 2. Multiple bins with approximately flat and equal depth
-    std::vector<DrawBin> alpha_bins;
-    std::unordered_map<BinKey, DrawBin> opaque_bins;
+    memory::frame_vector<DrawBin> alpha_bins;
+    memory::frame_unordered_map<BinKey, DrawBin> opaque_bins;
 
     for (const ProcessedSpriteDraw& processed_draw : processed_draws_in)
     {
         const bool requires_alpha =
             processed_draw.instance_data.color.w < 0.999f ||
-            processed_draw.texture->transparency() == TransparencyMode::translucent;
+            processed_draw.sprite->texture()->transparency() == TransparencyMode::translucent;
 
-        const BinKey bin_key = std::make_tuple(processed_draw.texture, requires_alpha);
+        const BinKey bin_key = std::make_tuple(processed_draw.sprite->texture(), requires_alpha);
 
         // Opaque sprites can always be binned together if they have compatible textures
         if (!requires_alpha)
@@ -237,7 +308,7 @@ void SpriteBatcher::emit_draws(const std::vector<DrawBin>& draw_bins_in, std::ve
 
 DrawCall SpriteBatcher::emit_simple_draw(const DrawBin& draw_bin)
 {
-    const peng::shared_ref<const Texture> texture = std::get<0>(draw_bin.key).to_shared_ref();
+    const peng::shared_ref<const Texture>& texture = draw_bin.texture();
     const bool requires_alpha = std::get<1>(draw_bin.key);
     const SpriteInstanceData& instance_data = draw_bin.instance_data()[0];
 
@@ -270,7 +341,7 @@ DrawCall SpriteBatcher::emit_instanced_draw(const DrawBin& draw_bin)
     SCOPED_EVENT("SpriteBatcher - emit instanced draw", strtools::catf_temp("%d sprites", num_sprites));
     check(num_sprites > 1);
 
-    const peng::shared_ref<const Texture> texture = std::get<0>(draw_bin.key).to_shared_ref();
+    const peng::shared_ref<const Texture>& texture = draw_bin.texture();
     const bool requires_alpha = std::get<1>(draw_bin.key);
 
     const MaterialPoolKey pool_key = std::make_tuple(true, requires_alpha);
@@ -282,8 +353,9 @@ DrawCall SpriteBatcher::emit_instanced_draw(const DrawBin& draw_bin)
     if (requires_blend)
     {
         // Translucent sprites need to be drawn in reverse z-depth order
-        std::vector<SpriteInstanceData> reversed_instance_data(draw_bin.instance_data());
-        std::ranges::reverse(reversed_instance_data);
+        memory::frame_vector<SpriteInstanceData> reversed_instance_data(
+            draw_bin.instance_data().rbegin(), draw_bin.instance_data().rend()
+        );
 
         buffer->upload(reversed_instance_data);
     }
@@ -330,7 +402,7 @@ SpriteBatcher::ProcessedSpriteDraw SpriteBatcher::preprocess_draw(const SpriteDr
     const Vector2f tex_offset = Vector2f(pos_corrected) / texture_res;
 
     return ProcessedSpriteDraw{
-        .texture = sprite->texture(),
+        .sprite = sprite,
         .z_depth = mvp_matrix.get_translation().z,
         .instance_data = SpriteInstanceData{
             .color = sprite_draw.color,
@@ -4,7 +4,8 @@
 #include <variant>
 #include <unordered_map>
 
-#include <memory/shared_ptr.h>
+#include <memory/borrowed_ptr.h>
+#include <memory/frame_allocator.h>
 #include <math/matrix4x4.h>
 #include <utils/hash_helpers.h>
 
@@ -17,6 +18,7 @@ namespace rendering
 
     class Mesh;
     class Material;
+    class Sprite;
     class Texture;
 
     // Converts a set of sprite draw calls into regular draw calls
@@ -34,6 +36,10 @@ namespace rendering
         void flush();
 
     private:
+        // Fewer draws than this are preprocessed and sorted on the calling thread alone
+        static constexpr size_t parallel_threshold = 1024;
+        static constexpr size_t parallel_batch_size = 256;
+
         // Instance data that can vary per sprite between draw
         struct SpriteInstanceData
         {
@@ -43,9 +49,10 @@ namespace rendering
             math::Vector2f tex_offset;
         };
 
+        // Processed draws and bins only borrow the sprite, which is kept alive by its draw call
         struct ProcessedSpriteDraw
         {
-            peng::shared_ref<const Texture> texture;
+            peng::borrowed_ptr<const Sprite> sprite;
             float z_depth = 0;
             SpriteInstanceData instance_data;
         };
@@ -61,7 +68,7 @@ namespace rendering
         using MaterialPool = ResourcePool<Material>;
         using MaterialPoolKey = std::tuple<bool, bool>;
 
-        using BinKey = std::tuple<peng::shared_ptr<const Texture>, bool>;
+        using BinKey = std::tuple<peng::borrowed_ptr<const Texture>, bool>;
 
         class DrawBin
         {
@@ -69,7 +76,8 @@ namespace rendering
             DrawBin();
 
             void add_draw(const ProcessedSpriteDraw& processed_draw, const BinKey& bin_key);
-            [[nodiscard]] const std::vector<SpriteInstanceData>& instance_data() const noexcept;
+            [[nodiscard]] const memory::frame_vector<SpriteInstanceData>& instance_data() const noexcept;
+            [[nodiscard]] const peng::shared_ref<const Texture>& texture() const;
 
             [[nodiscard]] float avg_depth() const noexcept;
             [[nodiscard]] bool approx_flat() const noexcept;
@@ -79,8 +87,9 @@ namespace rendering
             BinKey key;
 
         private:
+            peng::borrowed_ptr<const Sprite> _sprite;
             math::Vector2f _depth_range;
-            std::vector<SpriteInstanceData> _instance_data;
+            memory::frame_vector<SpriteInstanceData> _instance_data;
 
             static constexpr float epsilon = 0.00001f;
         };
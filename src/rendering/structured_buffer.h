@@ -1,12 +1,14 @@
 #pragma once
 
-#include <vector>
+#include <span>
 #include <string>
 
+#include <memory/ref_count.h>
 #include <profiling/scoped_event.h>
 #include <utils/check.h>
 
 #include "shader_buffer.h"
+#include "gpu_deletion_queue.h"
 
 namespace rendering
 {
@@ -14,6 +16,9 @@ namespace rendering
     class StructuredBuffer : public IShaderBuffer
     {
     public:
+        // Structured buffers are only ever referenced from the render thread
+        static constexpr peng::RefCountPolicy ref_count_policy = peng::RefCountPolicy::local;
+
         StructuredBuffer(const std::string& name, GLenum usage);
         ~StructuredBuffer() override;
 
@@ -22,7 +27,7 @@ namespace rendering
         StructuredBuffer& operator=(const StructuredBuffer&) = delete;
         StructuredBuffer& operator=(StructuredBuffer&&) = delete;
 
-        void upload(const std::vector<T>& data);
+        void upload(std::span<const T> data);
 
         [[nodiscard]] GLuint get_ssbo() const override;
 
@@ -53,7 +58,7 @@ namespace rendering
     }
 
     template <typename T>
-    void StructuredBuffer<T>::upload(const std::vector<T>& data)
+    void StructuredBuffer<T>::upload(std::span<const T> data)
     {
         SCOPED_EVENT("StructuredBuffer - upload", _name.c_str());
 
@@ -97,7 +102,7 @@ namespace rendering
         {
             SCOPED_EVENT("StructuredBuffer - release", _name.c_str());
 
-            glDeleteBuffers(1, &_ssbo);
+            GpuDeletionQueue::get().retire(GpuResourceType::buffer, _ssbo);
             _ssbo = 0;
             _capacity = 0;
             _size = 0;
@@ -14,6 +14,8 @@
 #include <libs/stb/stb_image.h>
 #pragma warning( pop )
 
+#include "gpu_deletion_queue.h"
+
 using namespace rendering;
 
 Texture::Texture(const std::string& name, const std::string& texture_path, const Config& config)
@@ -93,7 +95,7 @@ Texture::~Texture()
     SCOPED_EVENT("Destroying texture", _name.c_str());
     Logger::log("Destroying texture '%s'", _name.c_str());
 
-    glDeleteTextures(1, &_tex);
+    GpuDeletionQueue::get().retire(GpuResourceType::texture, _tex);
 }
 
 peng::shared_ref<Texture> Texture::load_asset(const Archive& archive)
@@ -14,6 +14,8 @@
 #include <profiling/scoped_event.h>
 #include <profiling/scoped_gpu_event.h>
 
+#include "gpu_deletion_queue.h"
+
 // Causes the NVIDIA GPU to be used over integrated graphics on dual GPU systems (such as laptops)
 // https://developer.download.nvidia.com/devzone/devcenter/gamegraphics/files/OptimusRenderingPolicies.pdf
 extern "C" {
@@ -187,6 +189,9 @@ void WindowSubsystem::shutdown()
 	check(_active);
 	_active = false;
 
+	// Anything retired after this point is leaked along with the context
+	GpuDeletionQueue::get().flush_all();
+
 	if (_window)
 	{
 		glfwDestroyWindow(_window);
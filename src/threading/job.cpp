@@ -2,17 +2,54 @@
 
 namespace threading
 {
-    Job::Job(std::function<void()> f)
-        : _f(f)
-    { }
+    Job::Job(Job&& other) noexcept
+        : _operations(std::exchange(other._operations, nullptr))
+    {
+        if (_operations)
+        {
+            _operations->relocate(other._storage, _storage);
+        }
+    }
+
+    Job& Job::operator=(Job&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+
+            _operations = std::exchange(other._operations, nullptr);
+            if (_operations)
+            {
+                _operations->relocate(other._storage, _storage);
+            }
+        }
+
+        return *this;
+    }
+
+    Job::~Job()
+    {
+        reset();
+    }
+
+    void Job::execute()
+    {
+        if (_operations)
+        {
+            _operations->invoke(_storage);
+        }
+    }
 
-    void Job::execute() const
+    void Job::reset() noexcept
     {
-        _f();
+        if (_operations)
+        {
+            std::exchange(_operations, nullptr)->destroy(_storage);
+        }
     }
 
-    Job Job::empty()
+    bool Job::empty() const noexcept
     {
-        return Job([] {});
+        return !_operations;
     }
 }
\ No newline at end of file
@@ -1,18 +1,112 @@
 #pragma once
 
-#include <functional>
+#include <new>
+#include <cstddef>
+#include <utility>
+#include <concepts>
+#include <type_traits>
 
 namespace threading
 {
+    // Move-only type erased callable
+    // Callables of up to inline_capacity bytes are stored within the job itself so that scheduling them
+    // never allocates, larger callables fall back to a single heap allocation
     class Job
     {
     public:
-        Job(std::function<void()> f);
+        static constexpr size_t inline_capacity = 64;
 
-        void execute() const;
-        static Job empty();
+        template <typename F>
+        static constexpr bool stores_inline =
+            sizeof(F) <= inline_capacity
+            && alignof(F) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible_v<F>;
+
+        // Constructs an empty job, which does nothing when executed
+        Job() noexcept = default;
+
+        template <typename F>
+        requires (!std::same_as<std::decay_t<F>, Job>) && std::invocable<std::decay_t<F>&>
+        Job(F&& f);
+
+        Job(Job&& other) noexcept;
+        Job& operator=(Job&& other) noexcept;
+        ~Job();
+
+        Job(const Job&) = delete;
+        Job& operator=(const Job&) = delete;
+
+        void execute();
+
+        // Destroys the callable, releasing anything it captured
+        void reset() noexcept;
+
+        [[nodiscard]] bool empty() const noexcept;
 
     private:
-        std::function<void()> _f;
+        struct Operations
+        {
+            void (*invoke)(void* storage);
+
+            // Move constructs the callable into the destination and destroys the source
+            void (*relocate)(void* source, void* destination) noexcept;
+            void (*destroy)(void* storage) noexcept;
+        };
+
+        template <typename F>
+        static constexpr Operations inline_operations = {
+            .invoke = [](void* storage)
+            {
+                (*std::launder(static_cast<F*>(storage)))();
+            },
+            .relocate = [](void* source, void* destination) noexcept
+            {
+                F* callable = std::launder(static_cast<F*>(source));
+                ::new (destination) F(std::move(*callable));
+                callable->~F();
+            },
+            .destroy = [](void* storage) noexcept
+            {
+                std::launder(static_cast<F*>(storage))->~F();
+            }
+        };
+
+        // The storage holds a pointer to the heap allocated callable
+        template <typename F>
+        static constexpr Operations heap_operations = {
+            .invoke = [](void* storage)
+            {
+                (**static_cast<F**>(storage))();
+            },
+            .relocate = [](void* source, void* destination) noexcept
+            {
+                *static_cast<F**>(destination) = *static_cast<F**>(source);
+            },
+            .destroy = [](void* storage) noexcept
+            {
+                delete *static_cast<F**>(storage);
+            }
+        };
+
+        alignas(std::max_align_t) std::byte _storage[inline_capacity];
+        const Operations* _operations = nullptr;
     };
+
+    template <typename F>
+    requires (!std::same_as<std::decay_t<F>, Job>) && std::invocable<std::decay_t<F>&>
+    Job::Job(F&& f)
+    {
+        using Callable = std::decay_t<F>;
+
+        if constexpr (stores_inline<Callable>)
+        {
+            ::new (static_cast<void*>(_storage)) Callable(std::forward<F>(f));
+            _operations = &inline_operations<Callable>;
+        }
+        else
+        {
+            ::new (static_cast<void*>(_storage)) Callable*(new Callable(std::forward<F>(f)));
+            _operations = &heap_operations<Callable>;
+        }
+    }
 }
\ No newline at end of file
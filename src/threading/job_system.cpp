@@ -0,0 +1,360 @@
+#include "job_system.h"
+
+#include <utility>
+
+#include <profiling/scoped_event.h>
+#include <utils/strtools.h>
+#include <utils/check.h>
+
+#pragma warning( push, 0 )
+#include <windows.h>
+#pragma warning( pop )
+
+using namespace threading;
+using namespace threading::detail;
+
+namespace
+{
+    constexpr size_t nodes_per_chunk = 256;
+
+    // Index of the calling thread's deque, or -1 for threads outside of the job system
+    thread_local int32_t this_thread_index = -1;
+
+    // Job executing on the calling thread, restored afterwards since waiting executes jobs within jobs
+    thread_local JobNode* this_thread_job = nullptr;
+
+    // Picks steal victims, seeded per thread so that thieves spread out across the deques
+    uint32_t next_random() noexcept
+    {
+        thread_local uint32_t state = 0x9E3779B9u ^ static_cast<uint32_t>(this_thread_index + 1) * 0x85EBCA6Bu;
+
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        return state;
+    }
+}
+
+JobSystem::JobSystem()
+    : Singleton()
+    , _running(true)
+    , _work_epoch(0)
+    , _num_sleeping(0)
+{
+    const size_t num_workers = get_auto_worker_count();
+
+    this_thread_index = 0;
+    _deques.reserve(num_workers + 1);
+
+    for (size_t i = 0; i < num_workers + 1; i++)
+    {
+        _deques.push_back(std::make_unique<WorkStealingDeque<JobNode>>());
+    }
+
+    _workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; i++)
+    {
+        _workers.emplace_back([this, thread_index = static_cast<int32_t>(i + 1)] {
+            worker_routine(thread_index);
+        });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    if (_running)
+    {
+        shutdown();
+    }
+}
+
+JobHandle JobSystem::schedule(Job&& job, JobCounter* counter)
+{
+    return schedule_node(std::move(job), nullptr, counter);
+}
+
+JobHandle JobSystem::schedule_child(const JobHandle& parent, Job&& job, JobCounter* counter)
+{
+    check(!parent.done());
+
+    // The parent is still executing or has children of its own outstanding, so it can't complete underneath us
+    parent._node->unfinished.fetch_add(1, std::memory_order_relaxed);
+    return schedule_node(std::move(job), parent._node, counter);
+}
+
+JobHandle JobSystem::current_job() const noexcept
+{
+    JobNode* node = this_thread_job;
+    return node
+        ? JobHandle(node, node->generation.load(std::memory_order_relaxed))
+        : JobHandle();
+}
+
+void JobSystem::wait(const JobHandle& handle)
+{
+    SCOPED_EVENT("JobSystem - wait");
+    execute_until([&handle] { return handle.done(); });
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    SCOPED_EVENT("JobSystem - wait");
+    execute_until([&counter] { return counter.done(); });
+}
+
+void JobSystem::shutdown()
+{
+    SCOPED_EVENT("JobSystem - shutdown");
+
+    _running = false;
+    _work_epoch.fetch_add(1);
+    _work_epoch.notify_all();
+
+    for (std::thread& worker : _workers)
+    {
+        worker.join();
+    }
+
+    _workers.clear();
+
+    while (JobNode* node = find_job())
+    {
+        execute(node);
+    }
+}
+
+bool JobSystem::running() const noexcept
+{
+    return _running.load(std::memory_order_relaxed);
+}
+
+size_t JobSystem::num_workers() const noexcept
+{
+    return _workers.size();
+}
+
+size_t JobSystem::num_threads() const noexcept
+{
+    return _workers.size() + 1;
+}
+
+JobHandle JobSystem::schedule_node(Job&& job, JobNode* parent, JobCounter* counter)
+{
+    if (counter)
+    {
+        counter->_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    JobNode* node = acquire_node();
+    node->job = std::move(job);
+    node->parent = parent;
+    node->counter = counter;
+    node->unfinished.store(1, std::memory_order_relaxed);
+
+    const JobHandle handle(node, node->generation.load(std::memory_order_relaxed));
+
+    if (!running())
+    {
+        execute(node);
+        return handle;
+    }
+
+    push(node);
+    wake_worker();
+
+    return handle;
+}
+
+void JobSystem::push(JobNode* node)
+{
+    const int32_t thread_index = this_thread_index;
+    if (thread_index >= 0 && _deques[thread_index]->push(node))
+    {
+        return;
+    }
+
+    _shared_queue.enqueue(node);
+}
+
+void JobSystem::wake_worker()
+{
+    // Pairs with the fence in worker_routine, either the worker sees the new job or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (_num_sleeping.load(std::memory_order_relaxed) > 0)
+    {
+        _work_epoch.fetch_add(1, std::memory_order_relaxed);
+        _work_epoch.notify_one();
+    }
+}
+
+void JobSystem::execute(JobNode* node)
+{
+    JobNode* const outer_job = std::exchange(this_thread_job, node);
+    node->job.execute();
+    this_thread_job = outer_job;
+
+    finish(node);
+}
+
+void JobSystem::finish(JobNode* node)
+{
+    while (node)
+    {
+        if (node->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        JobNode* parent = node->parent;
+        JobCounter* counter = node->counter;
+
+        node->job.reset();
+        node->generation.fetch_add(1, std::memory_order_release);
+        release_node(node);
+
+        // The waiter may return and destroy the counter as soon as it reaches zero, so it is touched last
+        if (counter)
+        {
+            counter->_pending.fetch_sub(1, std::memory_order_release);
+        }
+
+        node = parent;
+    }
+}
+
+JobNode* JobSystem::find_job()
+{
+    const int32_t thread_index = this_thread_index;
+    if (thread_index >= 0)
+    {
+        if (JobNode* node = _deques[thread_index]->pop())
+        {
+            return node;
+        }
+    }
+
+    JobNode* node = nullptr;
+    if (_shared_queue.try_dequeue(node))
+    {
+        return node;
+    }
+
+    const size_t num_deques = _deques.size();
+    const size_t first_victim = next_random() % num_deques;
+
+    for (size_t i = 0; i < num_deques; i++)
+    {
+        const size_t victim = (first_victim + i) % num_deques;
+        if (static_cast<int32_t>(victim) == thread_index)
+        {
+            continue;
+        }
+
+        if (JobNode* stolen = _deques[victim]->steal())
+        {
+            return stolen;
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename Pred>
+void JobSystem::execute_until(Pred&& done)
+{
+    while (!done())
+    {
+        JobNode* node = find_job();
+        if (!node)
+        {
+            // The remaining jobs are executing on other threads, spinning is profiled so idle waits show up in captures
+            SCOPED_EVENT("JobSystem - spin wait");
+            do
+            {
+                std::this_thread::yield();
+                node = find_job();
+            }
+            while (!node && !done());
+        }
+
+        if (node)
+        {
+            execute(node);
+        }
+    }
+}
+
+JobNode* JobSystem::acquire_node()
+{
+    JobNode* node = nullptr;
+    if (_free_nodes.try_dequeue(node))
+    {
+        return node;
+    }
+
+    std::lock_guard lock(_node_chunk_lock);
+
+    std::unique_ptr<JobNode[]>& chunk = _node_chunks.emplace_back(std::make_unique<JobNode[]>(nodes_per_chunk));
+    for (size_t i = 1; i < nodes_per_chunk; i++)
+    {
+        _free_nodes.enqueue(&chunk[i]);
+    }
+
+    return &chunk[0];
+}
+
+void JobSystem::release_node(JobNode* node)
+{
+    _free_nodes.enqueue(node);
+}
+
+void JobSystem::worker_routine(int32_t thread_index)
+{
+    if (GetProcAddress(GetModuleHandle(L"kernel32.dll"), "SetThreadDescription"))
+    {
+        const std::string name = strtools::catf("JobWorker_%d", thread_index);
+        const std::wstring w_name = std::wstring(name.begin(), name.end());
+        SetThreadDescription(GetCurrentThread(), w_name.c_str());
+    }
+
+    this_thread_index = thread_index;
+
+    while (_running.load(std::memory_order_acquire))
+    {
+        if (JobNode* node = find_job())
+        {
+            execute(node);
+            continue;
+        }
+
+        // Announce that we are about to sleep, then look again so a job scheduled in between isn't missed
+        const uint32_t epoch = _work_epoch.load(std::memory_order_relaxed);
+        _num_sleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        JobNode* node = find_job();
+        if (!node && _running.load(std::memory_order_acquire))
+        {
+            _work_epoch.wait(epoch, std::memory_order_relaxed);
+        }
+
+        _num_sleeping.fetch_sub(1, std::memory_order_relaxed);
+
+        if (node)
+        {
+            execute(node);
+        }
+    }
+}
+
+size_t JobSystem::get_auto_worker_count()
+{
+    // The main thread executes jobs as well whenever it waits on them, so a single core needs no workers
+    // A count of 0 means the hardware concurrency is unknown
+    const uint32_t threads = std::thread::hardware_concurrency();
+    return threads > 0
+        ? threads - 1
+        : 7;
+}
\ No newline at end of file
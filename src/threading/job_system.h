@@ -0,0 +1,226 @@
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <ranges>
+#include <cstdint>
+#include <algorithm>
+#include <concepts>
+
+#include <common/common.h>
+#include <utils/singleton.h>
+
+#include "job.h"
+#include "work_stealing_deque.h"
+
+namespace threading
+{
+    class JobCounter;
+
+    namespace detail
+    {
+        struct JobNode
+        {
+            Job job;
+            JobNode* parent = nullptr;
+            JobCounter* counter = nullptr;
+
+            // The job itself plus every child that has yet to complete
+            std::atomic<int32_t> unfinished = 0;
+
+            // Bumped once the job and its children complete, which invalidates every handle to the node
+            std::atomic<uint32_t> generation = 0;
+        };
+    }
+
+    // Counts outstanding jobs scheduled against it, so that a whole group of jobs can be waited on at once
+    // The counter must outlive every job scheduled against it
+    class JobCounter
+    {
+    public:
+        JobCounter() noexcept = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter(JobCounter&&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+        JobCounter& operator=(JobCounter&&) = delete;
+
+        [[nodiscard]] bool done() const noexcept
+        {
+            return _pending.load(std::memory_order_acquire) == 0;
+        }
+
+        [[nodiscard]] int32_t pending() const noexcept
+        {
+            return _pending.load(std::memory_order_relaxed);
+        }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<int32_t> _pending = 0;
+    };
+
+    // Refers to a single scheduled job and remains safe to query after the job has completed
+    // A default constructed handle refers to no job and is always done
+    class JobHandle
+    {
+    public:
+        JobHandle() noexcept = default;
+
+        // A job is only done once all of its children are done too
+        [[nodiscard]] bool done() const noexcept
+        {
+            return !_node || _node->generation.load(std::memory_order_acquire) != _generation;
+        }
+
+    private:
+        friend class JobSystem;
+
+        JobHandle(detail::JobNode* node, uint32_t generation) noexcept
+            : _node(node)
+            , _generation(generation)
+        { }
+
+        detail::JobNode* _node = nullptr;
+        uint32_t _generation = 0;
+    };
+
+    // Runs jobs on a fixed set of worker threads, each owning a deque that idle workers steal from
+    // The thread that creates the job system is treated as the main thread. It owns a deque as well
+    // and executes jobs while it waits, so waiting on work never leaves it idle
+    class JobSystem : public utils::Singleton<JobSystem>
+    {
+        friend Singleton;
+
+    public:
+        ~JobSystem();
+
+        JobHandle schedule(Job&& job, JobCounter* counter = nullptr);
+
+        // The parent is not done until the child is, so a parent can fan out work without waiting on it
+        // Must be called from within the parent job, or from one of its children
+        JobHandle schedule_child(const JobHandle& parent, Job&& job, JobCounter* counter = nullptr);
+
+        // Handle to the job executing on the calling thread, lets a job schedule children of itself
+        [[nodiscard]] JobHandle current_job() const noexcept;
+
+        // Executes other jobs on the calling thread until the handle or counter is done
+        void wait(const JobHandle& handle);
+        void wait(const JobCounter& counter);
+
+        // Calls f(index) for every index in [0, count), split into batches of at least min_batch_size
+        // The calling thread executes batches too and the call returns once every index has been processed
+        template <std::invocable<size_t> F>
+        void parallel_for(size_t count, size_t min_batch_size, F&& f);
+
+        // Calls f(element) for every element of the range
+        template <std::ranges::random_access_range R, typename F>
+        requires std::ranges::sized_range<R> && std::invocable<F&, std::ranges::range_reference_t<R>>
+        void parallel_for(R&& range, size_t min_batch_size, F&& f);
+
+        // Executes any remaining jobs and joins the workers, later jobs execute immediately on the scheduling thread
+        void shutdown();
+
+        [[nodiscard]] bool running() const noexcept;
+        [[nodiscard]] size_t num_workers() const noexcept;
+
+        // Number of threads that execute jobs, including the main thread
+        [[nodiscard]] size_t num_threads() const noexcept;
+
+    private:
+        JobSystem();
+
+        JobHandle schedule_node(Job&& job, detail::JobNode* parent, JobCounter* counter);
+
+        void push(detail::JobNode* node);
+        void wake_worker();
+        void execute(detail::JobNode* node);
+        void finish(detail::JobNode* node);
+
+        // Takes a job from the thread's own deque, then the shared queue, and otherwise steals one
+        [[nodiscard]] detail::JobNode* find_job();
+
+        template <typename Pred>
+        void execute_until(Pred&& done);
+
+        [[nodiscard]] detail::JobNode* acquire_node();
+        void release_node(detail::JobNode* node);
+
+        void worker_routine(int32_t thread_index);
+
+        static size_t get_auto_worker_count();
+
+        std::atomic<bool> _running;
+        std::vector<std::thread> _workers;
+
+        // One deque per thread, the main thread's deque comes first
+        std::vector<std::unique_ptr<WorkStealingDeque<detail::JobNode>>> _deques;
+
+        // Jobs scheduled from threads without a deque, or when a deque is full
+        common::concurrent_queue<detail::JobNode*> _shared_queue;
+
+        // Idle workers sleep on the epoch, which is only bumped when a worker might be sleeping
+        std::atomic<uint32_t> _work_epoch;
+        std::atomic<int32_t> _num_sleeping;
+
+        common::concurrent_queue<detail::JobNode*> _free_nodes;
+        std::mutex _node_chunk_lock;
+        std::vector<std::unique_ptr<detail::JobNode[]>> _node_chunks;
+    };
+
+    template <std::invocable<size_t> F>
+    void JobSystem::parallel_for(size_t count, size_t min_batch_size, F&& f)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // A few batches per thread lets threads that finish early steal the remainder from slower ones
+        const size_t max_batches = num_threads() * 4;
+        const size_t batch_size = std::max({ min_batch_size, (count + max_batches - 1) / max_batches, size_t(1) });
+        const size_t num_batches = (count + batch_size - 1) / batch_size;
+
+        auto execute_batch = [&f, count, batch_size](size_t batch)
+        {
+            const size_t end = std::min((batch + 1) * batch_size, count);
+            for (size_t index = batch * batch_size; index < end; index++)
+            {
+                f(index);
+            }
+        };
+
+        if (num_batches == 1 || !running())
+        {
+            for (size_t batch = 0; batch < num_batches; batch++)
+            {
+                execute_batch(batch);
+            }
+
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t batch = 1; batch < num_batches; batch++)
+        {
+            schedule(Job([&execute_batch, batch] { execute_batch(batch); }), &counter);
+        }
+
+        execute_batch(0);
+        wait(counter);
+    }
+
+    template <std::ranges::random_access_range R, typename F>
+    requires std::ranges::sized_range<R> && std::invocable<F&, std::ranges::range_reference_t<R>>
+    void JobSystem::parallel_for(R&& range, size_t min_batch_size, F&& f)
+    {
+        const auto begin = std::ranges::begin(range);
+        parallel_for(std::ranges::size(range), min_batch_size, [&f, &begin](size_t index)
+        {
+            f(begin[static_cast<std::ranges::range_difference_t<R>>(index)]);
+        });
+    }
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace threading
+{
+    // Fixed capacity Chase-Lev deque of pointers
+    // The owning thread pushes and pops at the bottom without contention, while any other thread
+    // may steal from the top. Only the last remaining item is ever contended between the two ends
+    template <typename T, size_t Capacity = 4096>
+    class WorkStealingDeque
+    {
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        WorkStealingDeque() noexcept = default;
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque(WorkStealingDeque&&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+        // Owner only, returns false if the deque is full
+        [[nodiscard]] bool push(T* item) noexcept
+        {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+            const int64_t top = _top.load(std::memory_order_acquire);
+
+            if (bottom - top >= static_cast<int64_t>(Capacity))
+            {
+                return false;
+            }
+
+            _items[bottom & mask].store(item, std::memory_order_relaxed);
+            _bottom.store(bottom + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // Owner only, takes the most recently pushed item or returns nullptr if empty
+        [[nodiscard]] T* pop() noexcept
+        {
+            const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+            _bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            int64_t top = _top.load(std::memory_order_relaxed);
+            if (top > bottom)
+            {
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = _items[bottom & mask].load(std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last item, race any thieves for it
+                if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                {
+                    item = nullptr;
+                }
+
+                _bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+
+            return item;
+        }
+
+        // Any thread, takes the oldest item or returns nullptr if empty or another thread won the race
+        [[nodiscard]] T* steal() noexcept
+        {
+            int64_t top = _top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = _bottom.load(std::memory_order_acquire);
+
+            if (top >= bottom)
+            {
+                return nullptr;
+            }
+
+            T* item = _items[top & mask].load(std::memory_order_relaxed);
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return nullptr;
+            }
+
+            return item;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr int64_t mask = static_cast<int64_t>(Capacity) - 1;
+
+        // The two ends are written by different threads, so they are kept on separate cache lines
+        alignas(64) std::atomic<int64_t> _top = 0;
+        alignas(64) std::atomic<int64_t> _bottom = 0;
+        alignas(64) std::array<std::atomic<T*>, Capacity> _items = {};
+    };
+}
\ No newline at end of file
@@ -46,12 +46,12 @@ void WorkerThread::shutdown()
 
 void WorkerThread::flush_job_queue()
 {
-    schedule_job(Job::empty());
+    schedule_job(Job());
 }
 
 void WorkerThread::worker_routine()
 {
-    Job job = Job::empty();
+    Job job;
     decltype(_job_queue)::consumer_token_t dequeue_token(_job_queue);
 
     while (_running)
@@ -66,6 +66,7 @@ void WorkerThread::worker_routine()
 
         _worker_busy = true;
         job.execute();
+        job.reset();
         _worker_busy = false;
     }
 }
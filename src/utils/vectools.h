@@ -33,8 +33,8 @@ namespace vectools
         return v.size() * sizeof(T);
     }
 
-    template <typename T>
-    T* try_back(std::vector<T>& v)
+    template <typename T, typename Alloc>
+    T* try_back(std::vector<T, Alloc>& v)
     {
         if (v.empty())
         {